@@ -0,0 +1,101 @@
+/*
+ * Scaling benchmark of concurrent accumulation into a 256x256 histogram.
+ *
+ * For 1 to hardware_concurrency() threads, each thread scatters the same number of
+ * += 1 updates at pseudo-random coordinates through one of:
+ *   - mutex:  a shared matrix guarded by a std::mutex;
+ *   - atomic: ysc::accumulator::atomic_add(), with one stripe of counters per thread;
+ *   - shard:  ysc::accumulator private shards, followed by a parallel reduce().
+ * Reported times are wall-clock milliseconds, reduction included.
+ */
+#include <matrix_accumulate.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+constexpr std::size_t side = 256;
+constexpr std::size_t updates_per_thread = 1 << 22;
+
+using histogram = ysc::matrix<std::uint64_t, side, side>;
+
+// xorshift, cheap enough not to dominate the measure
+struct coordinates
+{
+    std::uint32_t state;
+
+    std::uint32_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+// make_update(t) returns the update function of thread t
+template<class MakeUpdate>
+double run(std::size_t threads, MakeUpdate&& make_update)
+{
+    auto const start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0 ; t < threads ; ++t) {
+        workers.emplace_back([&make_update, t] {
+            auto update = make_update(t);
+            coordinates random{static_cast<std::uint32_t>(2463534242u + t)};
+            for (std::size_t u = 0 ; u < updates_per_thread ; ++u) {
+                std::uint32_t const r = random.next();
+                update((r >> 8) % side, (r >> 20) % side);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // anonymous namespace
+
+int main()
+{
+    std::size_t const max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%8s %12s %12s %12s\n", "threads", "mutex (ms)", "atomic (ms)", "shard (ms)");
+
+    for (std::size_t threads = 1 ; threads <= max_threads ; ++threads) {
+        auto const shared = std::make_unique<histogram>(ysc::zero);
+        std::mutex lock;
+        double const mutex_ms = run(threads, [&](std::size_t) {
+            return [&](std::size_t x, std::size_t y) {
+                std::lock_guard<std::mutex> const guard{lock};
+                ++(*shared)(x, y);
+            };
+        });
+
+        ysc::accumulator<std::uint64_t, side, side> atomic{1, threads};
+        double const atomic_ms = run(threads, [&](std::size_t) {
+            return [&](std::size_t x, std::size_t y) { atomic.atomic_add(x, y, 1); };
+        });
+
+        ysc::accumulator<std::uint64_t, side, side> sharded{threads};
+        double shard_ms = run(threads, [&](std::size_t t) {
+            return [&local = sharded.shard(t)](std::size_t x, std::size_t y) { ++local(x, y); };
+        });
+        auto const start = std::chrono::steady_clock::now();
+        auto const total = std::make_unique<histogram>();
+        sharded.reduce(ysc::parallel, *total);
+        shard_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("%8zu %12.1f %12.1f %12.1f\n", threads, mutex_ms, atomic_ms, shard_ms);
+        if ((*total)(0, 0) + (*shared)(0, 0) == 0) {
+            std::printf("(unexpected empty histograms)\n");
+        }
+    }
+}
@@ -16,6 +16,12 @@
 #include <numeric>
 #include <algorithm>
 #include <exception>
+#include <stdexcept>
+#include <iterator>
+#include <functional>
+#include <tuple>
+#include <thread>
+#include <vector>
 
 namespace ysc
 {
@@ -25,13 +31,34 @@ namespace _details
     OutputIt partial_product(InputIt first, InputIt last, OutputIt output)
     { *output++ = 1; return partial_sum(first, last, output, std::multiplies<>{}); }
 
+    constexpr std::size_t cache_line_size = 64;
+
+    // over-aligned holder keeping its value away from its neighbors' cache lines
+    template<class T>
+    struct alignas(cache_line_size) cache_aligned
+    { T value; };
+
+    // joins the workers still running when leaving scope, even through an exception
+    struct thread_joiner
+    {
+        std::vector<std::thread>& threads;
+        ~thread_joiner()
+        {
+            for (auto& thread : threads) {
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+        }
+    };
+
     // cache-friendly:
     // neighbor objects within the right-most coordinate are neighbors in memory
     template<class TDim, class TCoord>
     auto coordinates_to_index(TDim const& dimensions, TCoord const& coords)
     {
-        std::array<std::size_t, dimensions.size()> dimension_product;
-        using std::crbegin, std::crend, std::prev;
+        std::array<std::size_t, std::tuple_size_v<TDim>> dimension_product;
+        using std::begin, std::cbegin, std::cend, std::crbegin, std::crend, std::prev;
         partial_product(crbegin(dimensions), prev(crend(dimensions)), begin(dimension_product));
         return std::inner_product(cbegin(dimension_product), cend(dimension_product), crbegin(coords), 0);
     }
@@ -43,6 +70,13 @@ namespace _details
  */
 constexpr struct matrix_zero_t {} zero;
 
+/**
+ * @brief Tag an operation to be spread over several threads.
+ * @see contract(parallel_t, matrix<T, DimsA...> const&, matrix<T, DimsB...> const&)
+ * @see accumulator::reduce(parallel_t) const
+ */
+constexpr struct parallel_t {} parallel;
+
 /**
  * @brief Multi-dimensional container encapsulating a fixed size matrix.
  * @tparam T          Element type
@@ -197,7 +231,7 @@ public: // assignment operators (copy)
      */
     template<class U>
     matrix& operator=(matrix<U, Dimensions...> const& other)
-    { std::copy(cbegin(other._data), cend(other._data), begin(_data)); }
+    { std::copy(cbegin(other._data), cend(other._data), begin(_data)); return *this; }
 
 public: // assignment operators (move)
     /**
@@ -213,7 +247,7 @@ public: // assignment operators (move)
      */
     template<class U>
     matrix& operator=(matrix<U, Dimensions...> && other)
-    { std::move(cbegin(other._data), cend(other._data), begin(_data)); }
+    { std::move(cbegin(other._data), cend(other._data), begin(_data)); return *this; }
 
 public: // element access
     /**
@@ -273,6 +307,24 @@ public: // element access
         }
         return (*this)(coordinates...);
     }
+
+    /**
+     * @brief Returns a pointer to the underlying array serving as element storage.
+     *
+     * Elements are stored contiguously in row-major order: neighbor objects within the
+     * right-most coordinate are neighbors in memory.
+     */
+    T const* data() const noexcept
+    { return _data.data(); }
+
+    /**
+     * @brief Returns a pointer to the underlying array serving as element storage.
+     *
+     * Elements are stored contiguously in row-major order: neighbor objects within the
+     * right-most coordinate are neighbors in memory.
+     */
+    T* data() noexcept
+    { return _data.data(); }
 };
 } // namespace ysc
 
@@ -0,0 +1,312 @@
+/**
+ * @file matrix_accumulate.hpp
+ * @author Yankel Scialom (YSC) <yankel-pro@scialom.org>
+ * @date 2019
+ *
+ * @copyright This project is released under GNU Lesser General Public License; see
+ *            COPYING and COPYING.LESSER files attached.
+ *
+ * Concurrent accumulation into a @c ysc::matrix: many threads scatter additions into
+ * the same logical matrix without serializing on a lock.
+ */
+#ifndef YSC_MATRIX_ACCUMULATE_HPP
+#define YSC_MATRIX_ACCUMULATE_HPP
+
+#include "matrix.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace ysc
+{
+namespace _details
+{
+    // reductions of at least this many additions are worth spreading over threads
+    constexpr std::size_t reduce_parallel_limit = 1 << 18;
+
+    template<class T>
+    void atomic_add(std::atomic<T>& target, T value)
+    {
+        if constexpr (std::is_integral_v<T>) {
+            target.fetch_add(value, std::memory_order_relaxed);
+        } else {
+            T expected = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(expected, expected + value, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    // per-thread ticket, handed out round-robin to threads in order of first call
+    inline std::size_t thread_ticket()
+    {
+        static std::atomic<std::size_t> next{0};
+        thread_local std::size_t const ticket = next.fetch_add(1, std::memory_order_relaxed);
+        return ticket;
+    }
+}
+
+/**
+ * @brief Matrix accumulating additions from several threads concurrently.
+ * @tparam T          Element type
+ * @tparam Dimensions Dimensions of the accumulated matrix
+ *
+ * The accumulated matrix is the sum of:
+ *   - one private shard per worker, a plain @c matrix which its worker updates without
+ *     any synchronization; shards suit dense updates and are allocated on first use;
+ *   - a few stripes of atomic counters updated by @c atomic_add() from any thread; they
+ *     suit sparse updates for which a whole shard per worker would be wasteful. Each
+ *     thread is assigned one stripe, so threads on distinct stripes never share a cache
+ *     line even when they update neighboring elements; each stripe is a separate
+ *     allocation, aligned and padded to whole cache lines, made on first use by one of
+ *     its threads.
+ *
+ * @c reduce() merges all of them into a single @c matrix.
+ *
+ * ### Thread safety
+ * Distinct workers may use their shards concurrently, and @c atomic_add() may be called
+ * from any thread at any time. @c reduce() and @c clear() must not run concurrently with
+ * shard updates.
+ *
+ * @code
+ ysc::accumulator<std::uint64_t, 256, 256> histogram{workers};
+ // on worker w:
+ auto& local = histogram.shard(w);
+ local(x, y) += 1;
+ // once all workers are done:
+ auto const total = std::make_unique<ysc::matrix<std::uint64_t, 256, 256>>();
+ histogram.reduce(ysc::parallel, *total);
+ @endcode
+ */
+template<class T, std::size_t... Dimensions>
+class accumulator
+{
+public:
+    /** @brief Type of the accumulated matrix. */
+    using matrix_type = matrix<T, Dimensions...>;
+    /** @brief Order of the accumulated matrix. */
+    static constexpr std::size_t order      = sizeof...(Dimensions);
+    /** @brief Dimensions of the accumulated matrix. */
+    static constexpr std::array  dimensions = { Dimensions... };
+
+private:
+    static constexpr std::size_t linear_size = (Dimensions * ...);
+    // reductions split the matrix in chunks of whole cache lines
+    static constexpr std::size_t chunk_alignment = std::max<std::size_t>(1, _details::cache_line_size / sizeof(T));
+
+    using stripe_type = _details::cache_aligned<std::array<std::atomic<T>, linear_size>>;
+
+    // owns a stripe, installed by the first thread to use it
+    struct stripe_slot
+    {
+        std::atomic<stripe_type*> stripe{nullptr};
+        ~stripe_slot() { delete stripe.load(std::memory_order_relaxed); }
+    };
+
+    std::vector<std::unique_ptr<_details::cache_aligned<matrix_type>>> _shards;
+    std::vector<stripe_slot> _stripes;
+
+public:
+    /** @brief Default number of stripes of atomic counters. */
+    static constexpr std::size_t default_stripes = 4;
+
+    /**
+     * @brief Initializes a zero accumulator.
+     * @param workers Number of private shards; defaults to the number of hardware threads
+     * @param stripes Number of stripes of atomic counters, at least 1; each costs one
+     *                matrix worth of atomic counters once used by @c atomic_add()
+     */
+    explicit accumulator(std::size_t workers = std::max(1u, std::thread::hardware_concurrency()),
+                         std::size_t stripes = default_stripes)
+        : _shards(workers)
+        , _stripes(std::max<std::size_t>(1, stripes))
+    {}
+
+    /** @brief Returns the number of private shards. */
+    std::size_t workers() const noexcept
+    { return _shards.size(); }
+
+    /** @brief Returns the number of stripes of atomic counters. */
+    std::size_t stripes() const noexcept
+    { return _stripes.size(); }
+
+    /**
+     * @brief Returns the private shard of a worker.
+     * @param worker Index of the worker
+     *
+     * The shard is zero-initialized on first access. If @a worker is not less than
+     * @c workers(), an exception of type @c std::out_of_range is thrown.
+     */
+    matrix_type& shard(std::size_t worker)
+    {
+        if (worker >= _shards.size()) {
+            throw std::out_of_range{"accumulator::shard"};
+        }
+        auto& shard = _shards[worker];
+        if (!shard) {
+            shard.reset(new _details::cache_aligned<matrix_type>{matrix_type(zero)});
+        }
+        return shard->value;
+    }
+
+    /**
+     * @brief Atomically adds a value to the element at coordinates.
+     * @param args Coordinates of the element, followed by the value to add
+     *
+     * The counter updated belongs to the stripe of the calling thread, which is allocated
+     * and zero-initialized on first use. Lock-free whenever `std::atomic<T>` is, once the
+     * stripe exists. No bounds checking is performed.
+     */
+    template<class... Args>
+    void atomic_add(Args... args)
+    {
+        static_assert(sizeof...(Args) == order + 1, "atomic_add expects one coordinate per dimension and a value");
+        auto const arguments = std::make_tuple(args...);
+        std::size_t const index = index_of(arguments, std::make_index_sequence<order>{});
+        auto& slot = _stripes[_details::thread_ticket() % _stripes.size()];
+        stripe_type* stripe = slot.stripe.load(std::memory_order_acquire);
+        if (!stripe) {
+            stripe = install(slot);
+        }
+        _details::atomic_add(stripe->value[index], static_cast<T>(std::get<order>(arguments)));
+    }
+
+    /**
+     * @brief Returns the sum of all shards and stripes of atomic counters.
+     * @see reduce(matrix_type&) const for matrices too large for the stack
+     */
+    matrix_type reduce() const
+    {
+        matrix_type result;
+        reduce(result);
+        return result;
+    }
+
+    /**
+     * @brief Computes the sum of all shards and stripes of atomic counters into
+     *        caller-provided storage.
+     * @param result Sum; its previous content is overwritten
+     */
+    void reduce(matrix_type& result) const
+    { reduce_range(result.data(), 0, linear_size); }
+
+    /**
+     * @brief Returns the sum of all shards and stripes of atomic counters, spreading the
+     *        work over several threads.
+     * @see reduce(parallel_t, matrix_type&) const for matrices too large for the stack
+     */
+    matrix_type reduce(parallel_t) const
+    {
+        matrix_type result;
+        reduce(parallel, result);
+        return result;
+    }
+
+    /**
+     * @brief Computes the sum of all shards and stripes of atomic counters into
+     *        caller-provided storage, spreading the work over several threads.
+     * @param result Sum; its previous content is overwritten
+     *
+     * Small reductions run on the calling thread.
+     */
+    void reduce(parallel_t, matrix_type& result) const
+    {
+        std::size_t const chunks = (linear_size + chunk_alignment - 1) / chunk_alignment;
+        std::size_t const threads = linear_size * sources() >= _details::reduce_parallel_limit
+            ? std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), chunks)
+            : 1;
+        auto const bound = [&](std::size_t t) {
+            return std::min(linear_size, chunks * t / threads * chunk_alignment);
+        };
+
+        std::vector<std::thread> workers;
+        _details::thread_joiner const joiner{workers};
+        workers.reserve(threads - 1);
+        for (std::size_t t = 1 ; t < threads ; ++t) {
+            workers.emplace_back([this, &result, begin = bound(t), end = bound(t+1)] {
+                reduce_range(result.data(), begin, end);
+            });
+        }
+        reduce_range(result.data(), 0, bound(1));
+    }
+
+    /** @brief Resets every shard and atomic counter to zero. */
+    void clear()
+    {
+        for (auto& slot : _stripes) {
+            if (auto* const stripe = slot.stripe.load(std::memory_order_acquire)) {
+                for (auto& counter : stripe->value) {
+                    counter.store(T{}, std::memory_order_relaxed);
+                }
+            }
+        }
+        for (auto& shard : _shards) {
+            if (shard) {
+                std::fill(shard->value.data(), shard->value.data() + linear_size, T{});
+            }
+        }
+    }
+
+private:
+    template<class Tuple, std::size_t... I>
+    static std::size_t index_of(Tuple const& arguments, std::index_sequence<I...>)
+    {
+        std::array<std::size_t, order> const coordinates = { static_cast<std::size_t>(std::get<I>(arguments))... };
+        return _details::coordinates_to_index(dimensions, coordinates);
+    }
+
+    // number of allocated shards and stripes
+    std::size_t sources() const noexcept
+    {
+        std::size_t const shards = std::count_if(_shards.begin(), _shards.end(),
+            [](auto const& shard) { return shard != nullptr; });
+        std::size_t const stripes = std::count_if(_stripes.begin(), _stripes.end(),
+            [](stripe_slot const& slot) { return slot.stripe.load(std::memory_order_acquire) != nullptr; });
+        return shards + stripes;
+    }
+
+    static stripe_type* install(stripe_slot& slot)
+    {
+        auto fresh = std::make_unique<stripe_type>();
+        for (auto& counter : fresh->value) {
+            counter.store(T{}, std::memory_order_relaxed);
+        }
+        stripe_type* expected = nullptr;
+        if (slot.stripe.compare_exchange_strong(expected, fresh.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh.release();
+        }
+        return expected; // another thread installed it first
+    }
+
+    // only the shard loops vectorize; stripes are read one atomic load at a time
+    void reduce_range(T* output, std::size_t begin, std::size_t end) const
+    {
+        std::fill(output + begin, output + end, T{});
+        for (auto const& slot : _stripes) {
+            if (auto const* const stripe = slot.stripe.load(std::memory_order_acquire)) {
+                for (std::size_t i = begin ; i < end ; ++i) {
+                    output[i] += stripe->value[i].load(std::memory_order_relaxed);
+                }
+            }
+        }
+        for (auto const& shard : _shards) {
+            if (shard) {
+                T const* const source = shard->value.data();
+                for (std::size_t i = begin ; i < end ; ++i) {
+                    output[i] += source[i];
+                }
+            }
+        }
+    }
+};
+} // namespace ysc
+
+#endif // YSC_MATRIX_ACCUMULATE_HPP
@@ -0,0 +1,414 @@
+/**
+ * @file matrix_contract.hpp
+ * @author Yankel Scialom (YSC) <yankel-pro@scialom.org>
+ * @date 2019
+ *
+ * @copyright This project is released under GNU Lesser General Public License; see
+ *            COPYING and COPYING.LESSER files attached.
+ *
+ * Tensor contraction of @c ysc::matrix objects of arbitrary orders along axes chosen at
+ * compile time, with optional batch axes.
+ *
+ * A contraction is lowered to a (batched) matrix product: both operands are gathered into
+ * a `batch x rows x inner` and a `batch x inner x columns` layout, skipping the copy when
+ * an operand is already laid out that way, then multiplied by the cache-blocked kernel of
+ * matrix_linalg.hpp. Small contractions skip the gather and run as a plain loop nest.
+ */
+#ifndef YSC_MATRIX_CONTRACT_HPP
+#define YSC_MATRIX_CONTRACT_HPP
+
+#include "matrix.hpp"
+#include "matrix_linalg.hpp"
+
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace ysc
+{
+/**
+ * @brief List of axes of a matrix, used to specify a contraction.
+ * @see contract()
+ */
+template<std::size_t... Axes>
+using axes = std::index_sequence<Axes...>;
+
+namespace _details
+{
+    // contractions of at most this many multiply-adds skip the gather and run as a loop nest
+    constexpr std::size_t contract_loop_limit = 1 << 14;
+
+    // contractions of at least this many multiply-adds are worth spreading over threads
+    constexpr std::size_t contract_parallel_limit = 1 << 18;
+
+    template<std::size_t N>
+    constexpr bool all_distinct(std::array<std::size_t, N> const& values)
+    {
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            for (std::size_t j = i+1 ; j < N ; ++j) {
+                if (values[i] == values[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template<std::size_t Order, std::size_t N>
+    constexpr bool all_below(std::array<std::size_t, N> const& values)
+    {
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            if (values[i] >= Order) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // axes of an order-Order matrix which are neither in first nor in second, in order
+    template<std::size_t Order, std::size_t N1, std::size_t N2>
+    constexpr auto free_axes(std::array<std::size_t, N1> const& first, std::array<std::size_t, N2> const& second)
+    {
+        std::array<std::size_t, Order - N1 - N2> result{};
+        std::size_t o = 0;
+        for (std::size_t axis = 0 ; axis < Order ; ++axis) {
+            bool used = false;
+            for (std::size_t i = 0 ; i < N1 ; ++i) {
+                used = used || first[i] == axis;
+            }
+            for (std::size_t i = 0 ; i < N2 ; ++i) {
+                used = used || second[i] == axis;
+            }
+            if (!used) {
+                result[o++] = axis;
+            }
+        }
+        return result;
+    }
+
+    template<std::size_t R, std::size_t N>
+    constexpr auto select(std::array<std::size_t, R> const& values, std::array<std::size_t, N> const& indices)
+    {
+        std::array<std::size_t, N> result{};
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            result[i] = values[indices[i]];
+        }
+        return result;
+    }
+
+    template<std::size_t N1, std::size_t N2, std::size_t N3>
+    constexpr auto concatenate(std::array<std::size_t, N1> const& first,
+                               std::array<std::size_t, N2> const& second,
+                               std::array<std::size_t, N3> const& third)
+    {
+        std::array<std::size_t, N1 + N2 + N3> result{};
+        for (std::size_t i = 0 ; i < N1 ; ++i) { result[i] = first[i]; }
+        for (std::size_t i = 0 ; i < N2 ; ++i) { result[N1 + i] = second[i]; }
+        for (std::size_t i = 0 ; i < N3 ; ++i) { result[N1 + N2 + i] = third[i]; }
+        return result;
+    }
+
+    template<std::size_t N>
+    constexpr bool equal(std::array<std::size_t, N> const& lhs, std::array<std::size_t, N> const& rhs)
+    {
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            if (lhs[i] != rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<std::size_t N>
+    constexpr std::size_t product(std::array<std::size_t, N> const& values)
+    {
+        std::size_t result = 1;
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            result *= values[i];
+        }
+        return result;
+    }
+
+    template<std::size_t N>
+    constexpr bool is_identity(std::array<std::size_t, N> const& permutation)
+    {
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            if (permutation[i] != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // offsets within a row-major matrix of dimensions dims of every element spanned by
+    // the given axes (all other coordinates being 0), enumerated in row-major order
+    template<std::size_t R, std::size_t N>
+    std::vector<std::size_t> axis_offsets(std::array<std::size_t, R> const& dims, std::array<std::size_t, N> const& axes)
+    {
+        std::array<std::size_t, R> strides{};
+        std::size_t stride = 1;
+        for (std::size_t i = R ; i-- > 0 ; ) {
+            strides[i] = stride;
+            stride *= dims[i];
+        }
+
+        std::vector<std::size_t> result{0};
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            std::vector<std::size_t> next;
+            next.reserve(result.size() * dims[axes[i]]);
+            for (std::size_t const offset : result) {
+                for (std::size_t c = 0 ; c < dims[axes[i]] ; ++c) {
+                    next.push_back(offset + c * strides[axes[i]]);
+                }
+            }
+            result = std::move(next);
+        }
+        return result;
+    }
+
+    template<class AxesA, class AxesB, class BatchA, class BatchB, class DimsA, class DimsB>
+    struct contraction;
+
+    template<std::size_t... CA, std::size_t... CB, std::size_t... BA, std::size_t... BB, std::size_t... DA, std::size_t... DB>
+    struct contraction<axes<CA...>, axes<CB...>, axes<BA...>, axes<BB...>, axes<DA...>, axes<DB...>>
+    {
+        static constexpr std::size_t order_a = sizeof...(DA);
+        static constexpr std::size_t order_b = sizeof...(DB);
+        static constexpr std::array<std::size_t, order_a> dims_a = { DA... };
+        static constexpr std::array<std::size_t, order_b> dims_b = { DB... };
+
+        static constexpr std::array<std::size_t, sizeof...(CA)> contracted_a = { CA... };
+        static constexpr std::array<std::size_t, sizeof...(CB)> contracted_b = { CB... };
+        static constexpr std::array<std::size_t, sizeof...(BA)> batch_a = { BA... };
+        static constexpr std::array<std::size_t, sizeof...(BB)> batch_b = { BB... };
+
+        static_assert(sizeof...(CA) == sizeof...(CB), "both operands must have as many contracted axes");
+        static_assert(sizeof...(BA) == sizeof...(BB), "both operands must have as many batch axes");
+        static_assert(all_below<order_a>(contracted_a) && all_below<order_a>(batch_a), "axis out of range for the left operand");
+        static_assert(all_below<order_b>(contracted_b) && all_below<order_b>(batch_b), "axis out of range for the right operand");
+        static_assert(all_distinct(concatenate(contracted_a, batch_a, std::array<std::size_t, 0>{})), "left operand axes must be distinct");
+        static_assert(all_distinct(concatenate(contracted_b, batch_b, std::array<std::size_t, 0>{})), "right operand axes must be distinct");
+        static_assert(equal(select(dims_a, contracted_a), select(dims_b, contracted_b)), "contracted axes must have matching dimensions");
+        static_assert(equal(select(dims_a, batch_a), select(dims_b, batch_b)), "batch axes must have matching dimensions");
+
+        static constexpr auto free_a = free_axes<order_a>(batch_a, contracted_a);
+        static constexpr auto free_b = free_axes<order_b>(batch_b, contracted_b);
+
+        // operands are multiplied as batch x rows x inner and batch x inner x columns
+        static constexpr auto layout_a = concatenate(batch_a, free_a, contracted_a);
+        static constexpr auto layout_b = concatenate(batch_b, contracted_b, free_b);
+
+        static constexpr std::size_t batch   = product(select(dims_a, batch_a));
+        static constexpr std::size_t rows    = product(select(dims_a, free_a));
+        static constexpr std::size_t inner   = product(select(dims_a, contracted_a));
+        static constexpr std::size_t columns = product(select(dims_b, free_b));
+
+        static constexpr auto dims = concatenate(select(dims_a, batch_a), select(dims_a, free_a), select(dims_b, free_b));
+        static constexpr std::size_t order = dims.size();
+    };
+
+    template<class T, class Contraction, class = std::make_index_sequence<Contraction::order>>
+    struct contraction_result;
+
+    template<class T, class Contraction, std::size_t... I>
+    struct contraction_result<T, Contraction, std::index_sequence<I...>>
+    { using type = matrix<T, Contraction::dims[I]...>; };
+
+    template<class T, class Contraction>
+    struct contraction_result<T, Contraction, std::index_sequence<>>
+    { using type = T; };
+
+    template<class T, class AxesA, class AxesB, class BatchA, class BatchB, class DimsA, class DimsB>
+    using contraction_result_t = typename contraction_result<T, contraction<AxesA, AxesB, BatchA, BatchB, DimsA, DimsB>>::type;
+
+    // gathers the elements of a row-major matrix into a batch x rows x inner layout
+    template<class T>
+    std::vector<T> gather(T const* source,
+                          std::vector<std::size_t> const& batch,
+                          std::vector<std::size_t> const& rows,
+                          std::vector<std::size_t> const& inner)
+    {
+        std::vector<T> result;
+        result.reserve(batch.size() * rows.size() * inner.size());
+        for (std::size_t const b : batch) {
+            for (std::size_t const r : rows) {
+                for (std::size_t const i : inner) {
+                    result.push_back(source[b + r + i]);
+                }
+            }
+        }
+        return result;
+    }
+
+    template<class Contraction, class T, std::size_t... DA, std::size_t... DB>
+    void contract(matrix<T, DA...> const& a, matrix<T, DB...> const& b, T* out, bool parallel)
+    {
+        using C = Contraction;
+        constexpr std::size_t flops = C::batch * C::rows * C::inner * C::columns;
+
+        constexpr bool a_in_layout = is_identity(C::layout_a);
+        constexpr bool b_in_layout = is_identity(C::layout_b);
+        if (!(a_in_layout && b_in_layout) && flops <= contract_loop_limit) {
+            auto const batch_a   = axis_offsets(C::dims_a, C::batch_a);
+            auto const rows_a    = axis_offsets(C::dims_a, C::free_a);
+            auto const inner_a   = axis_offsets(C::dims_a, C::contracted_a);
+            auto const batch_b   = axis_offsets(C::dims_b, C::batch_b);
+            auto const inner_b   = axis_offsets(C::dims_b, C::contracted_b);
+            auto const columns_b = axis_offsets(C::dims_b, C::free_b);
+            for (std::size_t bt = 0 ; bt < C::batch ; ++bt) {
+                for (std::size_t r = 0 ; r < C::rows ; ++r) {
+                    T* const out_row = out + (bt*C::rows + r) * C::columns;
+                    for (std::size_t i = 0 ; i < C::inner ; ++i) {
+                        T const a_ri = a.data()[batch_a[bt] + rows_a[r] + inner_a[i]];
+                        T const* const b_base = b.data() + batch_b[bt] + inner_b[i];
+                        for (std::size_t c = 0 ; c < C::columns ; ++c) {
+                            out_row[c] += a_ri * b_base[columns_b[c]];
+                        }
+                    }
+                }
+            }
+            return;
+        }
+
+        std::vector<T> a_gathered, b_gathered;
+        T const* lhs = a.data();
+        T const* rhs = b.data();
+        if constexpr (!a_in_layout) {
+            a_gathered = gather(a.data(),
+                                axis_offsets(C::dims_a, C::batch_a),
+                                axis_offsets(C::dims_a, C::free_a),
+                                axis_offsets(C::dims_a, C::contracted_a));
+            lhs = a_gathered.data();
+        }
+        if constexpr (!b_in_layout) {
+            b_gathered = gather(b.data(),
+                                axis_offsets(C::dims_b, C::batch_b),
+                                axis_offsets(C::dims_b, C::contracted_b),
+                                axis_offsets(C::dims_b, C::free_b));
+            rhs = b_gathered.data();
+        }
+
+        // multiplies rows [begin, end) of the flattened batch x rows range
+        auto const multiply = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t bt = begin / C::rows ; bt * C::rows < end ; ++bt) {
+                std::size_t const row_begin = std::max(begin, bt * C::rows) - bt * C::rows;
+                std::size_t const row_end = std::min(end, (bt+1) * C::rows) - bt * C::rows;
+                gemm(row_end - row_begin, C::columns, C::inner, T{1},
+                     lhs + (bt*C::rows + row_begin) * C::inner, C::inner,
+                     rhs + bt * C::inner * C::columns, C::columns,
+                     out + (bt*C::rows + row_begin) * C::columns, C::columns);
+            }
+        };
+
+        constexpr std::size_t total_rows = C::batch * C::rows;
+        std::size_t const threads = parallel && flops >= contract_parallel_limit
+            ? std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), total_rows)
+            : 1;
+        if (threads <= 1) {
+            multiply(0, total_rows);
+            return;
+        }
+        std::vector<std::thread> workers;
+        thread_joiner const joiner{workers};
+        workers.reserve(threads - 1);
+        for (std::size_t t = 1 ; t < threads ; ++t) {
+            workers.emplace_back(multiply, total_rows * t / threads, total_rows * (t+1) / threads);
+        }
+        multiply(0, total_rows / threads);
+    }
+
+    template<class AxesA, class AxesB, class BatchA, class BatchB, class T, std::size_t... DA, std::size_t... DB>
+    void contract(matrix<T, DA...> const& a, matrix<T, DB...> const& b,
+                  contraction_result_t<T, AxesA, AxesB, BatchA, BatchB, axes<DA...>, axes<DB...>>& result,
+                  bool parallel)
+    {
+        using C = contraction<AxesA, AxesB, BatchA, BatchB, axes<DA...>, axes<DB...>>;
+        if constexpr (C::order == 0) {
+            result = T{};
+            contract<C>(a, b, &result, parallel);
+        } else {
+            std::fill(result.data(), result.data() + product(C::dims), T{});
+            contract<C>(a, b, result.data(), parallel);
+        }
+    }
+
+    template<class AxesA, class AxesB, class BatchA, class BatchB, class T, std::size_t... DA, std::size_t... DB>
+    auto contract(matrix<T, DA...> const& a, matrix<T, DB...> const& b, bool parallel)
+    {
+        contraction_result_t<T, AxesA, AxesB, BatchA, BatchB, axes<DA...>, axes<DB...>> result;
+        contract<AxesA, AxesB, BatchA, BatchB>(a, b, result, parallel);
+        return result;
+    }
+}
+
+/**
+ * @brief Contracts two matrices along chosen axes.
+ * @tparam AxesA  Contracted axes of @a a, as an @c axes list
+ * @tparam AxesB  Contracted axes of @a b, paired one to one with @a AxesA
+ * @tparam BatchA Batch axes of @a a, as an @c axes list (none by default)
+ * @tparam BatchB Batch axes of @a b, paired one to one with @a BatchA
+ * @param  a      Left operand
+ * @param  b      Right operand
+ * @see the overload taking a third argument, for results too large for the stack
+ *
+ * Paired contracted axes are summed over; paired batch axes are iterated over in
+ * lockstep. The result has the batch axes first, then the remaining axes of @a a, then
+ * the remaining axes of @a b, each in their original order; when no axis remains, the
+ * result is a scalar. Paired axes must have the same dimension, which is checked at
+ * compile time.
+ *
+ * @code
+ ysc::matrix<double, 4, 5, 6> t;
+ ysc::matrix<double, 6, 7> m;
+ ysc::matrix<double, 4, 5, 7> tm = ysc::contract<ysc::axes<2>, ysc::axes<0>>(t, m);
+
+ ysc::matrix<double, 8, 3, 4> x;
+ ysc::matrix<double, 8, 4, 2> y;
+ ysc::matrix<double, 8, 3, 2> xy = ysc::contract<ysc::axes<2>, ysc::axes<1>, ysc::axes<0>, ysc::axes<0>>(x, y);
+ @endcode
+ */
+template<class AxesA, class AxesB, class BatchA = axes<>, class BatchB = axes<>, class T, std::size_t... DimsA, std::size_t... DimsB>
+auto contract(matrix<T, DimsA...> const& a, matrix<T, DimsB...> const& b)
+{ return _details::contract<AxesA, AxesB, BatchA, BatchB>(a, b, false); }
+
+/**
+ * @brief Contracts two matrices along chosen axes into caller-provided storage.
+ * @param a      Left operand
+ * @param b      Right operand
+ * @param result Contraction, of the type returned by
+ *               contract(matrix<T, DimsA...> const&, matrix<T, DimsB...> const&); its
+ *               previous content is overwritten. It must not alias @a a nor @a b.
+ * @see contract(matrix<T, DimsA...> const&, matrix<T, DimsB...> const&)
+ */
+template<class AxesA, class AxesB, class BatchA = axes<>, class BatchB = axes<>, class T, std::size_t... DimsA, std::size_t... DimsB>
+void contract(matrix<T, DimsA...> const& a, matrix<T, DimsB...> const& b,
+              _details::contraction_result_t<T, AxesA, AxesB, BatchA, BatchB, axes<DimsA...>, axes<DimsB...>>& result)
+{ _details::contract<AxesA, AxesB, BatchA, BatchB>(a, b, result, false); }
+
+/**
+ * @brief Contracts two matrices along chosen axes, spreading the work over several threads.
+ * @see contract(matrix<T, DimsA...> const&, matrix<T, DimsB...> const&)
+ *
+ * Large contractions are split by rows of the left operand, across all batches, over
+ * `std::thread::hardware_concurrency()` threads; small ones run on the calling thread.
+ */
+template<class AxesA, class AxesB, class BatchA = axes<>, class BatchB = axes<>, class T, std::size_t... DimsA, std::size_t... DimsB>
+auto contract(parallel_t, matrix<T, DimsA...> const& a, matrix<T, DimsB...> const& b)
+{ return _details::contract<AxesA, AxesB, BatchA, BatchB>(a, b, true); }
+
+/**
+ * @brief Contracts two matrices along chosen axes into caller-provided storage,
+ *        spreading the work over several threads.
+ * @see contract(parallel_t, matrix<T, DimsA...> const&, matrix<T, DimsB...> const&)
+ */
+template<class AxesA, class AxesB, class BatchA = axes<>, class BatchB = axes<>, class T, std::size_t... DimsA, std::size_t... DimsB>
+void contract(parallel_t, matrix<T, DimsA...> const& a, matrix<T, DimsB...> const& b,
+              _details::contraction_result_t<T, AxesA, AxesB, BatchA, BatchB, axes<DimsA...>, axes<DimsB...>>& result)
+{ _details::contract<AxesA, AxesB, BatchA, BatchB>(a, b, result, true); }
+} // namespace ysc
+
+#endif // YSC_MATRIX_CONTRACT_HPP
@@ -0,0 +1,821 @@
+/**
+ * @file matrix_linalg.hpp
+ * @author Yankel Scialom (YSC) <yankel-pro@scialom.org>
+ * @date 2019
+ *
+ * @copyright This project is released under GNU Lesser General Public License; see
+ *            COPYING and COPYING.LESSER files attached.
+ *
+ * Dense linear algebra on square @c ysc::matrix objects: LU factorization with partial
+ * pivoting, Cholesky factorization, linear system solving, inversion and determinant.
+ *
+ * Small matrices are factored by fully unrolled code generated at compile time; larger
+ * ones by right-looking blocked algorithms whose trailing updates are delegated to a
+ * cache-blocked matrix-multiply kernel.
+ */
+#ifndef YSC_MATRIX_LINALG_HPP
+#define YSC_MATRIX_LINALG_HPP
+
+#include "matrix.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace ysc
+{
+namespace _details
+{
+    // square matrices up to this order are factored by fully unrolled code
+    constexpr std::size_t linalg_unroll_limit = 8;
+
+    // square matrices above this order are factored by blocked algorithms,
+    // by panels of this many columns
+    constexpr std::size_t linalg_block_size = 64;
+
+    // gemm cache blocking: a gemm_k_block by gemm_n_block tile of the right-hand
+    // operand is reused across every row of the left-hand operand
+    constexpr std::size_t gemm_k_block = 64;
+    constexpr std::size_t gemm_n_block = 256;
+
+    template<std::size_t Begin, class F, std::size_t... I>
+    void static_for(F&& f, std::index_sequence<I...>)
+    { (f(std::integral_constant<std::size_t, Begin + I>{}), ...); }
+
+    // calls f(integral_constant<I>) for I in [Begin, End), unrolled at compile time
+    template<std::size_t Begin, std::size_t End, class F>
+    void static_for(F&& f)
+    {
+        if constexpr (Begin < End) {
+            static_for<Begin>(std::forward<F>(f), std::make_index_sequence<End - Begin>{});
+        }
+    }
+
+    // C += alpha A B
+    // A is m by k, B is k by n, C is m by n; all row-major with leading dimensions lda, ldb, ldc
+    template<class T>
+    void gemm(std::size_t m, std::size_t n, std::size_t k, T alpha,
+              T const* a, std::size_t lda,
+              T const* b, std::size_t ldb,
+              T* c, std::size_t ldc)
+    {
+        for (std::size_t jj = 0 ; jj < n ; jj += gemm_n_block) {
+            std::size_t const j_end = std::min(n, jj + gemm_n_block);
+            for (std::size_t pp = 0 ; pp < k ; pp += gemm_k_block) {
+                std::size_t const p_end = std::min(k, pp + gemm_k_block);
+                for (std::size_t i = 0 ; i < m ; ++i) {
+                    T* const c_row = c + i*ldc;
+                    T const* const a_row = a + i*lda;
+                    for (std::size_t p = pp ; p < p_end ; ++p) {
+                        T const a_ip = alpha * a_row[p];
+                        T const* const b_row = b + p*ldb;
+                        for (std::size_t j = jj ; j < j_end ; ++j) {
+                            c_row[j] += a_ip * b_row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // in-place LU factorization of the N by N row-major matrix a, fully unrolled;
+    // returns false if a is singular
+    template<std::size_t N, class T>
+    bool lu_unrolled(T* a, std::size_t* pivots)
+    {
+        using std::abs;
+        bool regular = true;
+        static_for<0, N>([&](auto j) {
+            constexpr std::size_t J = decltype(j)::value;
+            std::size_t p = J;
+            auto best = abs(a[J*N + J]);
+            static_for<J+1, N>([&](auto i) {
+                constexpr std::size_t I = decltype(i)::value;
+                if (abs(a[I*N + J]) > best) {
+                    best = abs(a[I*N + J]);
+                    p = I;
+                }
+            });
+            pivots[J] = p;
+            if (p != J) {
+                static_for<0, N>([&](auto c) {
+                    constexpr std::size_t C = decltype(c)::value;
+                    std::swap(a[J*N + C], a[p*N + C]);
+                });
+            }
+            if (a[J*N + J] == T{}) {
+                regular = false;
+                return;
+            }
+            static_for<J+1, N>([&](auto i) {
+                constexpr std::size_t I = decltype(i)::value;
+                a[I*N + J] /= a[J*N + J];
+                static_for<J+1, N>([&](auto c) {
+                    constexpr std::size_t C = decltype(c)::value;
+                    a[I*N + C] -= a[I*N + J] * a[J*N + C];
+                });
+            });
+        });
+        return regular;
+    }
+
+    // unblocked LU factorization of columns [k0, k1) of the n by n row-major matrix a,
+    // rows [k0, n); whole rows are swapped; returns false if a zero pivot was met
+    template<class T>
+    bool lu_panel(T* a, std::size_t n, std::size_t k0, std::size_t k1, std::size_t* pivots)
+    {
+        using std::abs;
+        bool regular = true;
+        for (std::size_t j = k0 ; j < k1 ; ++j) {
+            std::size_t p = j;
+            auto best = abs(a[j*n + j]);
+            for (std::size_t i = j+1 ; i < n ; ++i) {
+                if (abs(a[i*n + j]) > best) {
+                    best = abs(a[i*n + j]);
+                    p = i;
+                }
+            }
+            pivots[j] = p;
+            if (p != j) {
+                std::swap_ranges(a + j*n, a + (j+1)*n, a + p*n);
+            }
+            if (a[j*n + j] == T{}) {
+                regular = false;
+                continue;
+            }
+            T const* const pivot_row = a + j*n;
+            for (std::size_t i = j+1 ; i < n ; ++i) {
+                T* const row = a + i*n;
+                row[j] /= pivot_row[j];
+                for (std::size_t c = j+1 ; c < k1 ; ++c) {
+                    row[c] -= row[j] * pivot_row[c];
+                }
+            }
+        }
+        return regular;
+    }
+
+    // right-looking blocked LU factorization of the n by n row-major matrix a
+    template<class T>
+    bool lu_blocked(T* a, std::size_t n, std::size_t* pivots)
+    {
+        bool regular = true;
+        for (std::size_t k0 = 0 ; k0 < n ; k0 += linalg_block_size) {
+            std::size_t const k1 = std::min(n, k0 + linalg_block_size);
+            regular = lu_panel(a, n, k0, k1, pivots) && regular;
+            if (k1 == n) {
+                break;
+            }
+
+            // A12 <- L11^-1 A12
+            for (std::size_t j = k0 ; j < k1 ; ++j) {
+                T const* const src = a + j*n;
+                for (std::size_t i = j+1 ; i < k1 ; ++i) {
+                    T* const dst = a + i*n;
+                    T const l_ij = dst[j];
+                    for (std::size_t c = k1 ; c < n ; ++c) {
+                        dst[c] -= l_ij * src[c];
+                    }
+                }
+            }
+
+            // A22 <- A22 - L21 U12
+            gemm(n - k1, n - k1, k1 - k0, T{-1},
+                 a + k1*n + k0, n,
+                 a + k0*n + k1, n,
+                 a + k1*n + k1, n);
+        }
+        return regular;
+    }
+
+    // unblocked Cholesky factorization of the diagonal block [k0, k1) of the n by n
+    // row-major matrix a (lower triangle); returns false if not positive definite
+    template<class T>
+    bool cholesky_diagonal_block(T* a, std::size_t n, std::size_t k0, std::size_t k1)
+    {
+        using std::sqrt;
+        for (std::size_t j = k0 ; j < k1 ; ++j) {
+            T* const row_j = a + j*n;
+            if (!(row_j[j] > T{})) {
+                return false;
+            }
+            row_j[j] = sqrt(row_j[j]);
+            for (std::size_t i = j+1 ; i < k1 ; ++i) {
+                T* const row_i = a + i*n;
+                row_i[j] /= row_j[j];
+                for (std::size_t c = j+1 ; c <= i ; ++c) {
+                    row_i[c] -= row_i[j] * a[c*n + j];
+                }
+            }
+        }
+        return true;
+    }
+
+    // in-place Cholesky factorization of the N by N row-major matrix a (lower
+    // triangle), fully unrolled; returns false if not positive definite
+    template<std::size_t N, class T>
+    bool cholesky_unrolled(T* a)
+    {
+        using std::sqrt;
+        bool positive = true;
+        static_for<0, N>([&](auto j) {
+            constexpr std::size_t J = decltype(j)::value;
+            if (!positive || !(a[J*N + J] > T{})) {
+                positive = false;
+                return;
+            }
+            a[J*N + J] = sqrt(a[J*N + J]);
+            static_for<J+1, N>([&](auto i) {
+                constexpr std::size_t I = decltype(i)::value;
+                a[I*N + J] /= a[J*N + J];
+                static_for<J+1, I+1>([&](auto c) {
+                    constexpr std::size_t C = decltype(c)::value;
+                    a[I*N + C] -= a[I*N + J] * a[C*N + J];
+                });
+            });
+        });
+        return positive;
+    }
+
+    // right-looking blocked Cholesky factorization of the n by n row-major matrix a
+    template<class T>
+    bool cholesky_blocked(T* a, std::size_t n)
+    {
+        for (std::size_t k0 = 0 ; k0 < n ; k0 += linalg_block_size) {
+            std::size_t const k1 = std::min(n, k0 + linalg_block_size);
+            if (!cholesky_diagonal_block(a, n, k0, k1)) {
+                return false;
+            }
+            if (k1 == n) {
+                break;
+            }
+
+            // L21 <- A21 L11^-T
+            for (std::size_t i = k1 ; i < n ; ++i) {
+                T* const row_i = a + i*n;
+                for (std::size_t j = k0 ; j < k1 ; ++j) {
+                    T const* const row_j = a + j*n;
+                    T sum = row_i[j];
+                    for (std::size_t c = k0 ; c < j ; ++c) {
+                        sum -= row_i[c] * row_j[c];
+                    }
+                    row_i[j] = sum / row_j[j];
+                }
+            }
+
+            // A22 <- A22 - L21 L21^T, lower triangle only, by blocks of rows
+            std::size_t const kb = k1 - k0;
+            std::size_t const m = n - k1;
+            std::vector<T> l21_t(kb * m);
+            for (std::size_t i = 0 ; i < m ; ++i) {
+                for (std::size_t p = 0 ; p < kb ; ++p) {
+                    l21_t[p*m + i] = a[(k1+i)*n + k0 + p];
+                }
+            }
+            for (std::size_t r0 = 0 ; r0 < m ; r0 += linalg_block_size) {
+                std::size_t const r1 = std::min(m, r0 + linalg_block_size);
+                gemm(r1 - r0, r1, kb, T{-1},
+                     a + (k1+r0)*n + k0, n,
+                     l21_t.data(), m,
+                     a + (k1+r0)*n + k1, n);
+            }
+        }
+        return true;
+    }
+
+    // solves L U X = P B in place for the k right-hand sides stored as the columns of
+    // the n by k row-major matrix b
+    template<class T>
+    void lu_solve(T const* lu, std::size_t const* pivots, std::size_t n, T* b, std::size_t k)
+    {
+        for (std::size_t j = 0 ; j < n ; ++j) {
+            if (pivots[j] != j) {
+                std::swap_ranges(b + j*k, b + (j+1)*k, b + pivots[j]*k);
+            }
+        }
+        for (std::size_t j = 0 ; j < n ; ++j) {
+            T const* const src = b + j*k;
+            for (std::size_t i = j+1 ; i < n ; ++i) {
+                T const l_ij = lu[i*n + j];
+                T* const dst = b + i*k;
+                for (std::size_t c = 0 ; c < k ; ++c) {
+                    dst[c] -= l_ij * src[c];
+                }
+            }
+        }
+        for (std::size_t j = n ; j-- > 0 ; ) {
+            T* const src = b + j*k;
+            T const u_jj = lu[j*n + j];
+            for (std::size_t c = 0 ; c < k ; ++c) {
+                src[c] /= u_jj;
+            }
+            for (std::size_t i = 0 ; i < j ; ++i) {
+                T const u_ij = lu[i*n + j];
+                T* const dst = b + i*k;
+                for (std::size_t c = 0 ; c < k ; ++c) {
+                    dst[c] -= u_ij * src[c];
+                }
+            }
+        }
+    }
+
+    // solves L L^T X = B in place for the k right-hand sides stored as the columns of
+    // the n by k row-major matrix b
+    template<class T>
+    void cholesky_solve(T const* l, std::size_t n, T* b, std::size_t k)
+    {
+        for (std::size_t j = 0 ; j < n ; ++j) {
+            T* const src = b + j*k;
+            T const l_jj = l[j*n + j];
+            for (std::size_t c = 0 ; c < k ; ++c) {
+                src[c] /= l_jj;
+            }
+            for (std::size_t i = j+1 ; i < n ; ++i) {
+                T const l_ij = l[i*n + j];
+                T* const dst = b + i*k;
+                for (std::size_t c = 0 ; c < k ; ++c) {
+                    dst[c] -= l_ij * src[c];
+                }
+            }
+        }
+        for (std::size_t j = n ; j-- > 0 ; ) {
+            T* const src = b + j*k;
+            T const l_jj = l[j*n + j];
+            for (std::size_t c = 0 ; c < k ; ++c) {
+                src[c] /= l_jj;
+            }
+            T const* const row_j = l + j*n;
+            for (std::size_t i = 0 ; i < j ; ++i) {
+                T const l_ji = row_j[i];
+                T* const dst = b + i*k;
+                for (std::size_t c = 0 ; c < k ; ++c) {
+                    dst[c] -= l_ji * src[c];
+                }
+            }
+        }
+    }
+
+    // overwrites the n by n row-major matrix a with the identity
+    template<class T>
+    void set_identity(T* a, std::size_t n)
+    {
+        std::fill(a, a + n*n, T{});
+        for (std::size_t i = 0 ; i < n ; ++i) {
+            a[i*n + i] = T{1};
+        }
+    }
+}
+
+/**
+ * @brief Value held as a sign and the natural logarithm of its absolute value.
+ * @tparam T Element type
+ *
+ * The value is `sign * exp(log_abs)`. Used for determinants, which over- or underflow
+ * @c T long before the matrices they are computed from do. A null value has a null
+ * @c sign and a @c log_abs of minus infinity.
+ *
+ * @code
+ auto const [sign, log_abs] = ysc::log_determinant(m);
+ @endcode
+ */
+template<class T>
+struct signed_log
+{
+    /** @brief Sign of the value: -1, 0 or 1. */
+    T sign;
+    /** @brief Natural logarithm of the absolute value. */
+    T log_abs;
+};
+
+/**
+ * @brief LU factorization with partial pivoting of a square matrix.
+ * @tparam T Element type
+ * @tparam N Order of the factored matrix
+ *
+ * Holds `P A = L U` where @c P is a permutation, @c L is unit lower triangular and
+ * @c U is upper triangular; @c L (without its unit diagonal) and @c U are packed into
+ * a single `N` by `N` matrix, allocated on the heap. A factorization is computed once
+ * and can then be used to solve any number of systems `A x = b`, one by one or in a batch.
+ *
+ * @see lu()
+ */
+template<class T, std::size_t N>
+class lu_decomposition
+{
+    std::unique_ptr<matrix<T, N, N>> _lu;
+    std::array<std::size_t, N> _pivots;
+    bool _regular;
+
+public:
+    /**
+     * @brief Factors a matrix.
+     * @param m Matrix to factor
+     *
+     * Matrices of order up to 8 are factored by fully unrolled code; matrices of order
+     * greater than 64 are factored by a right-looking blocked algorithm.
+     *
+     * A singular matrix is still factored; @c singular() then returns @c true.
+     */
+    explicit lu_decomposition(matrix<T, N, N> const& m)
+        : _lu(std::make_unique<matrix<T, N, N>>(m))
+    {
+        if constexpr (N <= _details::linalg_unroll_limit) {
+            _regular = _details::lu_unrolled<N>(_lu->data(), _pivots.data());
+        } else if constexpr (N <= _details::linalg_block_size) {
+            _regular = _details::lu_panel(_lu->data(), N, 0, N, _pivots.data());
+        } else {
+            _regular = _details::lu_blocked(_lu->data(), N, _pivots.data());
+        }
+    }
+
+    /**
+     * @brief Returns the packed @c L and @c U factors.
+     *
+     * Elements strictly below the diagonal belong to @c L (whose diagonal is implicitly
+     * made of ones); the others belong to @c U.
+     */
+    matrix<T, N, N> const& packed() const noexcept
+    { return *_lu; }
+
+    /**
+     * @brief Returns the row permutation.
+     *
+     * Row @c i of the factored matrix was interchanged with row `pivots()[i]`, for @c i
+     * from @c 0 to `N-1`, in that order.
+     */
+    std::array<std::size_t, N> const& pivots() const noexcept
+    { return _pivots; }
+
+    /** @brief Tells whether the factored matrix is singular. */
+    bool singular() const noexcept
+    { return !_regular; }
+
+    /**
+     * @brief Returns the determinant of the factored matrix.
+     *
+     * The determinant is the product of @c N pivots, which easily overflows or
+     * underflows @c T for large @c N; see @c log_determinant().
+     */
+    T determinant() const
+    {
+        T result{1};
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            result *= _lu->data()[i*N + i];
+            if (_pivots[i] != i) {
+                result = -result;
+            }
+        }
+        return result;
+    }
+
+    /** @brief Returns the sign and the logarithm of the absolute determinant of the factored matrix. */
+    signed_log<T> log_determinant() const
+    {
+        signed_log<T> result{T{1}, T{0}};
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            T const pivot = _lu->data()[i*N + i];
+            if (pivot == T{0}) {
+                return {T{0}, -std::numeric_limits<T>::infinity()};
+            }
+            if ((pivot < T{0}) != (_pivots[i] != i)) {
+                result.sign = -result.sign;
+            }
+            result.log_abs += std::log(std::abs(pivot));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Solves `A X = B` for a batch of right-hand sides.
+     * @tparam K Number of right-hand sides
+     * @param  b Right-hand sides, one per column
+     *
+     * If the factored matrix is singular, an exception of type @c std::domain_error
+     * is thrown.
+     */
+    template<std::size_t K>
+    matrix<T, N, K> solve(matrix<T, N, K> const& b) const
+    {
+        matrix<T, N, K> x = b;
+        solve_in_place(x);
+        return x;
+    }
+
+    /**
+     * @brief Solves `A X = B` for a batch of right-hand sides into caller-provided storage.
+     * @param b Right-hand side(s): a vector, or one right-hand side per column
+     * @param x Solutions; may be @a b itself
+     *
+     * Prefer this form when the right-hand sides are too large for the stack.
+     * If the factored matrix is singular, an exception of type @c std::domain_error
+     * is thrown.
+     */
+    template<std::size_t... K>
+    void solve(matrix<T, N, K...> const& b, matrix<T, N, K...>& x) const
+    {
+        if (&x != &b) {
+            x = b;
+        }
+        solve_in_place(x);
+    }
+
+    /**
+     * @brief Solves `A x = b`.
+     * @param b Right-hand side
+     *
+     * If the factored matrix is singular, an exception of type @c std::domain_error
+     * is thrown.
+     */
+    matrix<T, N> solve(matrix<T, N> const& b) const
+    {
+        matrix<T, N> x = b;
+        solve_in_place(x);
+        return x;
+    }
+
+    /**
+     * @brief Solves `A X = B` for a batch of right-hand sides, in place.
+     * @tparam K Number of right-hand sides
+     * @param  b Right-hand sides, one per column, replaced by the solutions
+     *
+     * If the factored matrix is singular, an exception of type @c std::domain_error
+     * is thrown.
+     */
+    template<std::size_t... K>
+    void solve_in_place(matrix<T, N, K...>& b) const
+    {
+        static_assert(sizeof...(K) <= 1, "right-hand sides must be a vector or an order-2 matrix");
+        if (singular()) {
+            throw std::domain_error{"lu_decomposition::solve"};
+        }
+        _details::lu_solve(_lu->data(), _pivots.data(), N, b.data(), (std::size_t{1} * ... * K));
+    }
+
+    /**
+     * @brief Returns the inverse of the factored matrix.
+     *
+     * If the factored matrix is singular, an exception of type @c std::domain_error
+     * is thrown.
+     */
+    matrix<T, N, N> inverse() const
+    {
+        matrix<T, N, N> result;
+        inverse(result);
+        return result;
+    }
+
+    /**
+     * @brief Computes the inverse of the factored matrix into caller-provided storage.
+     * @param result Inverse of the factored matrix
+     *
+     * Prefer this form when `N` by `N` matrices are too large for the stack.
+     * If the factored matrix is singular, an exception of type @c std::domain_error
+     * is thrown.
+     */
+    void inverse(matrix<T, N, N>& result) const
+    {
+        _details::set_identity(result.data(), N);
+        solve_in_place(result);
+    }
+};
+
+/**
+ * @brief Cholesky factorization of a symmetric positive-definite matrix.
+ * @tparam T Element type
+ * @tparam N Order of the factored matrix
+ *
+ * Holds `A = L L^T` where @c L is lower triangular with a positive diagonal, allocated
+ * on the heap. Only the lower triangle of @c A is read.
+ *
+ * @see cholesky()
+ */
+template<class T, std::size_t N>
+class cholesky_decomposition
+{
+    std::unique_ptr<matrix<T, N, N>> _l;
+
+public:
+    /**
+     * @brief Factors a matrix.
+     * @param m Matrix to factor; only its lower triangle is read
+     *
+     * If @a m is not positive definite, an exception of type @c std::domain_error is
+     * thrown.
+     */
+    explicit cholesky_decomposition(matrix<T, N, N> const& m)
+        : _l(std::make_unique<matrix<T, N, N>>(m))
+    {
+        bool positive;
+        if constexpr (N <= _details::linalg_unroll_limit) {
+            positive = _details::cholesky_unrolled<N>(_l->data());
+        } else {
+            positive = _details::cholesky_blocked(_l->data(), N);
+        }
+        if (!positive) {
+            throw std::domain_error{"cholesky_decomposition::cholesky_decomposition"};
+        }
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            std::fill(_l->data() + i*N + i+1, _l->data() + (i+1)*N, T{});
+        }
+    }
+
+    /** @brief Returns the lower triangular factor @c L. */
+    matrix<T, N, N> const& lower() const noexcept
+    { return *_l; }
+
+    /**
+     * @brief Returns the determinant of the factored matrix.
+     *
+     * The determinant is the squared product of @c N diagonal elements, which easily
+     * overflows or underflows @c T for large @c N; see @c log_determinant().
+     */
+    T determinant() const
+    {
+        T result{1};
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            result *= _l->data()[i*N + i];
+        }
+        return result * result;
+    }
+
+    /**
+     * @brief Returns the sign and the logarithm of the absolute determinant of the factored matrix.
+     *
+     * The sign is always 1, the factored matrix being positive definite.
+     */
+    signed_log<T> log_determinant() const
+    {
+        signed_log<T> result{T{1}, T{0}};
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            result.log_abs += std::log(_l->data()[i*N + i]);
+        }
+        result.log_abs *= T{2};
+        return result;
+    }
+
+    /**
+     * @brief Solves `A X = B` for a batch of right-hand sides.
+     * @tparam K Number of right-hand sides
+     * @param  b Right-hand sides, one per column
+     */
+    template<std::size_t K>
+    matrix<T, N, K> solve(matrix<T, N, K> const& b) const
+    {
+        matrix<T, N, K> x = b;
+        solve_in_place(x);
+        return x;
+    }
+
+    /**
+     * @brief Solves `A X = B` for a batch of right-hand sides into caller-provided storage.
+     * @param b Right-hand side(s): a vector, or one right-hand side per column
+     * @param x Solutions; may be @a b itself
+     *
+     * Prefer this form when the right-hand sides are too large for the stack.
+     */
+    template<std::size_t... K>
+    void solve(matrix<T, N, K...> const& b, matrix<T, N, K...>& x) const
+    {
+        if (&x != &b) {
+            x = b;
+        }
+        solve_in_place(x);
+    }
+
+    /**
+     * @brief Solves `A x = b`.
+     * @param b Right-hand side
+     */
+    matrix<T, N> solve(matrix<T, N> const& b) const
+    {
+        matrix<T, N> x = b;
+        solve_in_place(x);
+        return x;
+    }
+
+    /**
+     * @brief Solves `A X = B` for a batch of right-hand sides, in place.
+     * @tparam K Number of right-hand sides
+     * @param  b Right-hand sides, one per column, replaced by the solutions
+     */
+    template<std::size_t... K>
+    void solve_in_place(matrix<T, N, K...>& b) const
+    {
+        static_assert(sizeof...(K) <= 1, "right-hand sides must be a vector or an order-2 matrix");
+        _details::cholesky_solve(_l->data(), N, b.data(), (std::size_t{1} * ... * K));
+    }
+
+    /** @brief Returns the inverse of the factored matrix. */
+    matrix<T, N, N> inverse() const
+    {
+        matrix<T, N, N> result;
+        inverse(result);
+        return result;
+    }
+
+    /**
+     * @brief Computes the inverse of the factored matrix into caller-provided storage.
+     * @param result Inverse of the factored matrix
+     *
+     * Prefer this form when `N` by `N` matrices are too large for the stack.
+     */
+    void inverse(matrix<T, N, N>& result) const
+    {
+        _details::set_identity(result.data(), N);
+        solve_in_place(result);
+    }
+};
+
+/**
+ * @brief Computes the LU factorization with partial pivoting of a square matrix.
+ * @param m Matrix to factor
+ * @see lu_decomposition
+ */
+template<class T, std::size_t N>
+lu_decomposition<T, N> lu(matrix<T, N, N> const& m)
+{ return lu_decomposition<T, N>{m}; }
+
+/**
+ * @brief Computes the Cholesky factorization of a symmetric positive-definite matrix.
+ * @param m Matrix to factor; only its lower triangle is read
+ *
+ * If @a m is not positive definite, an exception of type @c std::domain_error is thrown.
+ * @see cholesky_decomposition
+ */
+template<class T, std::size_t N>
+cholesky_decomposition<T, N> cholesky(matrix<T, N, N> const& m)
+{ return cholesky_decomposition<T, N>{m}; }
+
+/**
+ * @brief Solves `A X = B`.
+ * @param a Square matrix
+ * @param b Right-hand side(s): a vector, or one right-hand side per column
+ *
+ * To solve several systems sharing the same @a a, factor it once with @c lu() instead.
+ * If @a a is singular, an exception of type @c std::domain_error is thrown.
+ */
+template<class T, std::size_t N, std::size_t... K>
+matrix<T, N, K...> solve(matrix<T, N, N> const& a, matrix<T, N, K...> const& b)
+{ return lu(a).solve(b); }
+
+/**
+ * @brief Solves `A X = B` into caller-provided storage.
+ * @param a Square matrix
+ * @param b Right-hand side(s): a vector, or one right-hand side per column
+ * @param x Solutions; may be @a b itself
+ *
+ * If @a a is singular, an exception of type @c std::domain_error is thrown.
+ */
+template<class T, std::size_t N, std::size_t... K>
+void solve(matrix<T, N, N> const& a, matrix<T, N, K...> const& b, matrix<T, N, K...>& x)
+{ lu(a).solve(b, x); }
+
+/**
+ * @brief Returns the inverse of a square matrix.
+ * @param m Square matrix
+ *
+ * If @a m is singular, an exception of type @c std::domain_error is thrown.
+ */
+template<class T, std::size_t N>
+matrix<T, N, N> inverse(matrix<T, N, N> const& m)
+{ return lu(m).inverse(); }
+
+/**
+ * @brief Computes the inverse of a square matrix into caller-provided storage.
+ * @param m      Square matrix
+ * @param result Inverse of @a m; may be @a m itself
+ *
+ * If @a m is singular, an exception of type @c std::domain_error is thrown.
+ */
+template<class T, std::size_t N>
+void inverse(matrix<T, N, N> const& m, matrix<T, N, N>& result)
+{ lu(m).inverse(result); }
+
+/**
+ * @brief Returns the determinant of a square matrix.
+ * @param m Square matrix
+ *
+ * For large @a m, the determinant easily overflows or underflows @c T; see
+ * @c log_determinant().
+ */
+template<class T, std::size_t N>
+T determinant(matrix<T, N, N> const& m)
+{ return lu(m).determinant(); }
+
+/**
+ * @brief Returns the sign and the logarithm of the absolute determinant of a square matrix.
+ * @param m Square matrix
+ */
+template<class T, std::size_t N>
+signed_log<T> log_determinant(matrix<T, N, N> const& m)
+{ return lu(m).log_determinant(); }
+} // namespace ysc
+
+#endif // YSC_MATRIX_LINALG_HPP
@@ -0,0 +1,438 @@
+/**
+ * @file matrix_snapshot.hpp
+ * @author Yankel Scialom (YSC) <yankel-pro@scialom.org>
+ * @date 2019
+ *
+ * @copyright This project is released under GNU Lesser General Public License; see
+ *            COPYING and COPYING.LESSER files attached.
+ *
+ * Copy-on-write versioning of a @c ysc::matrix for read-heavy concurrent access: one
+ * writer publishes successive versions while many readers query immutable snapshots.
+ */
+#ifndef YSC_MATRIX_SNAPSHOT_HPP
+#define YSC_MATRIX_SNAPSHOT_HPP
+
+#include "matrix.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace ysc
+{
+/**
+ * @brief Maximum number of readers concurrently registered to a @c versioned_matrix.
+ *
+ * `ysc::versioned_matrix<int, 8> v{ysc::max_readers{4}};`
+ */
+struct max_readers
+{ std::size_t count; };
+
+/**
+ * @brief Matrix published as successive immutable versions sharing unmodified storage.
+ * @tparam T          Element type
+ * @tparam Dimensions Dimensions of the matrix
+ *
+ * Elements are stored in fixed-size tiles of @c tile_size consecutive elements (in
+ * row-major order). A version is a table of tiles; consecutive versions share every tile
+ * the writer did not modify in between.
+ *
+ * The writer modifies a pending version through @c modify(), which copies a tile the
+ * first time it is modified since the last publication, then makes it visible with
+ * @c publish(), which swaps in the new table with a single atomic store.
+ *
+ * Readers register once through @c register_reader(), then @c acquire() snapshots:
+ * taking a snapshot, reading through it and releasing it are wait-free. A snapshot keeps
+ * reading the version it was taken from, however many versions are published meanwhile.
+ *
+ * Versions and tiles superseded by a publication are reclaimed by epoch-based
+ * reclamation: they are freed once no reader holds a snapshot taken before the
+ * publication, the next time the writer calls @c publish() or @c reclaim().
+ *
+ * ### Thread safety
+ * @c modify(), @c publish(), @c reclaim() and @c operator()() must be called from a
+ * single writer thread. @c register_reader() may be called from any thread; a @c reader
+ * and its snapshots must be used by one thread at a time. Every @c reader must be
+ * destroyed before the @c versioned_matrix.
+ *
+ * @code
+ ysc::versioned_matrix<double, 1024, 1024> shared{initial};
+ // on a reader thread:
+ auto r = shared.register_reader();
+ {
+     auto const s = r.acquire();
+     double const x = s(3, 4);
+ }
+ // on the writer thread:
+ shared.modify(3, 4) = 42.;
+ shared.publish();
+ @endcode
+ */
+template<class T, std::size_t... Dimensions>
+class versioned_matrix
+{
+public:
+    /** @brief Order of the matrix. */
+    static constexpr std::size_t order      = sizeof...(Dimensions);
+    /** @brief Dimensions of the matrix. */
+    static constexpr std::array  dimensions = { Dimensions... };
+    /** @brief Number of elements per tile: one 4 KiB page worth of elements. */
+    static constexpr std::size_t tile_size  = std::max<std::size_t>(1, 4096 / sizeof(T));
+
+    class reader;
+    class snapshot;
+
+private:
+    static constexpr std::size_t linear_size = (Dimensions * ...);
+    static constexpr std::size_t tile_count  = (linear_size + tile_size - 1) / tile_size;
+    // epoch pinned by idle readers
+    static constexpr std::uint64_t idle = 0;
+
+    using tile = std::array<T, tile_size>;
+
+    struct version
+    {
+        std::array<tile const*, tile_count> tiles;
+        std::uint64_t number;
+    };
+
+    struct retired
+    {
+        std::uint64_t epoch;
+        version const* old_version;
+        std::vector<tile const*> old_tiles;
+    };
+
+    struct reader_slot
+    {
+        std::atomic<bool> taken;
+        std::atomic<std::uint64_t> epoch;
+        // live snapshots of the reader holding the slot; used by that reader only
+        std::size_t depth;
+    };
+
+    std::atomic<version const*> _current;
+    std::atomic<std::uint64_t> _epoch;
+    std::unique_ptr<_details::cache_aligned<reader_slot>[]> _slots;
+    std::size_t _slot_count;
+
+    // writer-side state
+    std::array<tile*, tile_count> _pending;
+    std::vector<bool> _copied;
+    std::vector<tile const*> _replaced;
+    std::vector<retired> _retired;
+    std::uint64_t _number;
+
+public:
+    /** @brief Maximum number of concurrently registered readers, unless specified. */
+    static constexpr max_readers default_max_readers = { 64 };
+
+    /**
+     * @brief Initializes version 0 with value-initialized elements.
+     * @param limit Maximum number of concurrently registered readers
+     */
+    explicit versioned_matrix(max_readers limit = default_max_readers)
+        : versioned_matrix(nullptr, limit)
+    {}
+
+    /**
+     * @brief Initializes version 0 as a copy of a matrix.
+     * @param initial Source matrix
+     * @param limit   Maximum number of concurrently registered readers
+     */
+    explicit versioned_matrix(matrix<T, Dimensions...> const& initial, max_readers limit = default_max_readers)
+        : versioned_matrix(initial.data(), limit)
+    {}
+
+    versioned_matrix(versioned_matrix const&) = delete;
+    versioned_matrix& operator=(versioned_matrix const&) = delete;
+
+    ~versioned_matrix()
+    {
+        for (auto& entry : _retired) {
+            dispose(entry);
+        }
+        for (tile const* replaced : _replaced) {
+            delete replaced;
+        }
+        for (tile* pending : _pending) {
+            delete pending;
+        }
+        delete _current.load();
+    }
+
+public: // writer
+    /**
+     * @brief Returns a reference to an element of the pending version.
+     * @param coordinates Coordinates of the element to return
+     *
+     * The tile holding the element is copied first unless it was already modified since
+     * the last publication; published versions are never modified. No bounds checking
+     * is performed.
+     *
+     * @warning The returned reference must not be used after the next @c publish(): it
+     * then designates an element of the published version, which readers may be reading.
+     * Call @c modify() again instead.
+     */
+    template<class... Coords>
+    T& modify(Coords... coordinates)
+    {
+        std::size_t const index = _details::coordinates_to_index(dimensions, std::array{coordinates...});
+        std::size_t const t = index / tile_size;
+        if (!_copied[t]) {
+            auto copy = std::make_unique<tile>(*_pending[t]);
+            _replaced.push_back(_pending[t]);
+            _pending[t] = copy.release();
+            _copied[t] = true;
+        }
+        return (*_pending[t])[index % tile_size];
+    }
+
+    /**
+     * @brief Returns a reference to an element of the pending version.
+     * @param coordinates Coordinates of the element to return
+     *
+     * No bounds checking is performed.
+     */
+    template<class... Coords>
+    T const& operator()(Coords... coordinates) const
+    {
+        std::size_t const index = _details::coordinates_to_index(dimensions, std::array{coordinates...});
+        return (*_pending[index / tile_size])[index % tile_size];
+    }
+
+    /**
+     * @brief Publishes the pending version.
+     *
+     * Snapshots taken from now on read the published version. Superseded storage is
+     * retired, then whatever retired storage no reader can reach anymore is freed.
+     */
+    void publish()
+    {
+        auto next = std::make_unique<version>();
+        next->number = _number + 1;
+        std::copy(_pending.begin(), _pending.end(), next->tiles.begin());
+        _retired.reserve(_retired.size() + 1);
+
+        // nothing below throws
+        version const* const previous = _current.exchange(next.release());
+        std::uint64_t const epoch = _epoch.fetch_add(1) + 1;
+        ++_number;
+
+        _retired.push_back(retired{epoch, previous, std::move(_replaced)});
+        _replaced.clear();
+        std::fill(_copied.begin(), _copied.end(), false);
+        reclaim();
+    }
+
+    /** @brief Frees retired storage no reader can reach anymore. */
+    void reclaim()
+    {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t s = 0 ; s < _slot_count ; ++s) {
+            std::uint64_t const pinned = _slots[s].value.epoch.load();
+            if (pinned != idle) {
+                oldest = std::min(oldest, pinned);
+            }
+        }
+
+        auto const reachable = std::partition(_retired.begin(), _retired.end(), [oldest](retired const& entry) {
+            return entry.epoch > oldest;
+        });
+        std::for_each(reachable, _retired.end(), dispose);
+        _retired.erase(reachable, _retired.end());
+    }
+
+    /** @brief Returns the number of the last published version, starting from 0. */
+    std::uint64_t published() const noexcept
+    { return _number; }
+
+    /** @brief Returns the number of superseded versions not yet freed. */
+    std::size_t retired_versions() const noexcept
+    { return _retired.size(); }
+
+public: // readers
+    /**
+     * @brief Registers a reader.
+     *
+     * If as many readers as the @c max_readers limit given at construction are already
+     * registered, an exception of type @c std::length_error is thrown.
+     */
+    reader register_reader()
+    {
+        for (std::size_t s = 0 ; s < _slot_count ; ++s) {
+            bool expected = false;
+            if (_slots[s].value.taken.compare_exchange_strong(expected, true)) {
+                _slots[s].value.depth = 0;
+                return reader{*this, _slots[s].value};
+            }
+        }
+        throw std::length_error{"versioned_matrix::reader"};
+    }
+
+    /**
+     * @brief Handle registered to read a @c versioned_matrix.
+     *
+     * Move-only; unregisters on destruction. Must outlive its snapshots.
+     */
+    class reader
+    {
+        friend class versioned_matrix;
+
+        versioned_matrix const* _owner;
+        reader_slot* _slot;
+
+        reader(versioned_matrix const& owner, reader_slot& slot)
+            : _owner(&owner), _slot(&slot)
+        {}
+
+    public:
+        reader(reader&& other) noexcept
+            : _owner(std::exchange(other._owner, nullptr))
+            , _slot(std::exchange(other._slot, nullptr))
+        {}
+
+        reader& operator=(reader&& other) noexcept
+        {
+            std::swap(_owner, other._owner);
+            std::swap(_slot, other._slot);
+            return *this;
+        }
+
+        ~reader()
+        {
+            if (_slot != nullptr) {
+                _slot->taken.store(false);
+            }
+        }
+
+        /**
+         * @brief Takes a snapshot of the last published version. Wait-free.
+         *
+         * Storage reachable from the snapshot is not freed until the snapshot, and every
+         * other snapshot of this reader, is destroyed.
+         */
+        snapshot acquire()
+        {
+            if (_slot->depth++ == 0) {
+                _slot->epoch.store(_owner->_epoch.load());
+            }
+            return snapshot{*_slot, *_owner->_current.load()};
+        }
+    };
+
+    /**
+     * @brief Immutable view of a published version.
+     *
+     * Move-only; releases the version on destruction.
+     */
+    class snapshot
+    {
+        friend class versioned_matrix;
+
+        reader_slot* _slot;
+        version const* _version;
+
+        snapshot(reader_slot& slot, version const& v)
+            : _slot(&slot), _version(&v)
+        {}
+
+    public:
+        snapshot(snapshot&& other) noexcept
+            : _slot(std::exchange(other._slot, nullptr))
+            , _version(other._version)
+        {}
+
+        snapshot& operator=(snapshot&& other) noexcept
+        {
+            std::swap(_slot, other._slot);
+            std::swap(_version, other._version);
+            return *this;
+        }
+
+        ~snapshot()
+        {
+            if (_slot != nullptr && --_slot->depth == 0) {
+                _slot->epoch.store(idle, std::memory_order_release);
+            }
+        }
+
+        /** @brief Returns the number of the version this snapshot reads. */
+        std::uint64_t number() const noexcept
+        { return _version->number; }
+
+        /**
+         * @brief Returns a reference to the element at coordinates.
+         * @param coordinates Coordinates of the element to return
+         *
+         * No bounds checking is performed.
+         */
+        template<class... Coords>
+        T const& operator()(Coords... coordinates) const
+        {
+            std::size_t const index = _details::coordinates_to_index(dimensions, std::array{coordinates...});
+            return (*_version->tiles[index / tile_size])[index % tile_size];
+        }
+
+        /** @brief Copies the version this snapshot reads into a matrix. */
+        matrix<T, Dimensions...> copy() const
+        {
+            matrix<T, Dimensions...> result;
+            for (std::size_t t = 0 ; t < tile_count ; ++t) {
+                std::size_t const count = std::min(tile_size, linear_size - t*tile_size);
+                std::copy_n(_version->tiles[t]->begin(), count, result.data() + t*tile_size);
+            }
+            return result;
+        }
+    };
+
+private:
+    versioned_matrix(T const* initial, max_readers limit)
+        : _current(nullptr)
+        , _epoch(1)
+        , _slots(std::make_unique<_details::cache_aligned<reader_slot>[]>(limit.count))
+        , _slot_count(limit.count)
+        , _copied(tile_count, false)
+        , _number(0)
+    {
+        for (std::size_t s = 0 ; s < _slot_count ; ++s) {
+            _slots[s].value.taken.store(false);
+            _slots[s].value.epoch.store(idle);
+            _slots[s].value.depth = 0;
+        }
+
+        // owned locally until every allocation and copy has succeeded
+        auto first = std::make_unique<version>(version{{}, 0});
+        std::vector<std::unique_ptr<tile>> tiles(tile_count);
+        for (std::size_t t = 0 ; t < tile_count ; ++t) {
+            tiles[t] = std::make_unique<tile>();
+            if (initial != nullptr) {
+                std::size_t const count = std::min(tile_size, linear_size - t*tile_size);
+                std::copy_n(initial + t*tile_size, count, tiles[t]->begin());
+            }
+        }
+        for (std::size_t t = 0 ; t < tile_count ; ++t) {
+            _pending[t] = tiles[t].release();
+            first->tiles[t] = _pending[t];
+        }
+        _current.store(first.release());
+    }
+
+    static void dispose(retired& entry)
+    {
+        for (tile const* old_tile : entry.old_tiles) {
+            delete old_tile;
+        }
+        delete entry.old_version;
+    }
+};
+} // namespace ysc
+
+#endif // YSC_MATRIX_SNAPSHOT_HPP
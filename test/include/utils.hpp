@@ -4,6 +4,8 @@
 #include <type_traits>
 #include <cstddef>
 #include <memory>
+#include <algorithm>
+#include <utility>
 
 namespace ysc::test
 {
@@ -14,21 +16,17 @@ class SideEffect
     bool invoked = false;
 
 public:
-    std::enable_if_t<
-        !std::is_same_v<void, Ret>,
-        Ret
-    >
-    trigger(Ret&& ret, Args&& ...)
+    // R is Ret; naming it through a dependent, non-deduced type keeps `ret` an rvalue
+    // reference to Ret while deferring its formation until Ret is known not to be void
+    template<class R = Ret, std::enable_if_t<!std::is_void_v<R>, int> = 0>
+    Ret trigger(typename std::enable_if<true, R>::type&& ret, Args&& ...)
     {
         invoked = true;
         return std::forward<Ret>(ret);
     }
 
-    std::enable_if_t<
-        std::is_same_v<void, Ret>,
-        Ret
-    >
-    trigger(Args&& ...)
+    template<class R = Ret, std::enable_if_t<std::is_void_v<R>, int> = 0>
+    void trigger(Args&& ...)
     {
         invoked = true;
     }
@@ -0,0 +1,171 @@
+#include <matrix_accumulate.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+//
+// --- SHARDS ---
+//
+
+// Expect shards to start at zero and to be summed by reduce
+TEST(accumulate, shards)
+{
+    ysc::accumulator<std::uint64_t, 2, 3> acc{3};
+    ASSERT_EQ(acc.workers(), 3u);
+    ASSERT_EQ(acc.shard(0)(1, 2), 0u);
+
+    acc.shard(0)(1, 2) += 5;
+    acc.shard(2)(1, 2) += 7;
+    acc.shard(2)(0, 0) += 1;
+
+    auto const total = acc.reduce();
+    ASSERT_EQ(total(1, 2), 12u);
+    ASSERT_EQ(total(0, 0), 1u);
+    ASSERT_EQ(total(0, 1), 0u);
+}
+
+// Expect out of range workers to throw
+TEST(accumulate, shard_outofbound)
+{
+    ysc::accumulator<int, 2> acc{1};
+
+    bool out_of_range_exception_catch = false;
+    try {
+        (void) acc.shard(1);
+    } catch (std::out_of_range&) {
+        out_of_range_exception_catch = true;
+    }
+    ASSERT_TRUE(out_of_range_exception_catch);
+}
+
+// Expect clear to reset shards and atomic counters
+TEST(accumulate, clear)
+{
+    ysc::accumulator<double, 2, 2> acc{1};
+    acc.shard(0)(0, 1) = 1.5;
+    acc.atomic_add(1, 0, 2.5);
+    acc.clear();
+
+    auto const total = acc.reduce();
+    ASSERT_DOUBLE_EQ(total(0, 1), 0.);
+    ASSERT_DOUBLE_EQ(total(1, 0), 0.);
+}
+
+
+//
+// --- CONCURRENT UPDATES ---
+//
+
+// Expect concurrent shard and atomic updates to be all accounted for
+TEST(accumulate, concurrent)
+{
+    constexpr std::size_t workers = 4;
+    constexpr std::size_t updates = 10000;
+    ysc::accumulator<std::uint64_t, 16, 16> acc{workers};
+
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0 ; w < workers ; ++w) {
+        threads.emplace_back([&acc, w] {
+            auto& local = acc.shard(w);
+            for (std::size_t u = 0 ; u < updates ; ++u) {
+                local(u % 16, (u / 16) % 16) += 1;
+                acc.atomic_add(0, 0, std::uint64_t{2});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto const total = acc.reduce();
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0 ; i < 16 ; ++i) {
+        for (std::size_t j = 0 ; j < 16 ; ++j) {
+            sum += total(i, j);
+        }
+    }
+    ASSERT_EQ(sum, workers * updates * 3);
+    ASSERT_EQ(total(0, 0), workers * (updates / 256 + 1) + workers * updates * 2);
+}
+
+// Expect atomic updates spread over several stripes to be summed by reduce
+TEST(accumulate, stripes)
+{
+    constexpr std::size_t threads = 6;
+    constexpr std::size_t updates = 5000;
+    ysc::accumulator<std::uint64_t, 4, 8> acc{1, 3};
+    ASSERT_EQ(acc.stripes(), 3u);
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0 ; t < threads ; ++t) {
+        workers.emplace_back([&acc] {
+            for (std::size_t u = 0 ; u < updates ; ++u) {
+                acc.atomic_add(u % 4, u % 8, std::uint64_t{1});
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto const total = acc.reduce();
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0 ; i < 4 ; ++i) {
+        for (std::size_t j = 0 ; j < 8 ; ++j) {
+            sum += total(i, j);
+        }
+    }
+    ASSERT_EQ(sum, threads * updates);
+    ASSERT_EQ(total(1, 1), threads * (updates / 8));
+}
+
+// Expect a parallel reduction to compute the same values as a sequential one
+TEST(accumulate, parallel_reduce)
+{
+    ysc::accumulator<std::uint64_t, 100, 37> acc{3};
+    for (std::size_t w = 0 ; w < 3 ; ++w) {
+        for (std::size_t i = 0 ; i < 100 ; ++i) {
+            for (std::size_t j = 0 ; j < 37 ; ++j) {
+                acc.shard(w)(i, j) = (w+1) * i + j;
+            }
+        }
+    }
+    acc.atomic_add(99, 36, 1);
+
+    auto const sequential = acc.reduce();
+    auto const parallel = acc.reduce(ysc::parallel);
+    for (std::size_t i = 0 ; i < 100 ; ++i) {
+        for (std::size_t j = 0 ; j < 37 ; ++j) {
+            ASSERT_EQ(parallel(i, j), sequential(i, j));
+            ASSERT_EQ(parallel(i, j), 6 * i + 3 * j + (i == 99 && j == 36 ? 1 : 0));
+        }
+    }
+}
+
+// Expect large accumulators to be reduced into caller-provided storage
+TEST(accumulate, reduce_large)
+{
+    constexpr std::size_t side = 1024;
+    auto const acc = std::make_unique<ysc::accumulator<std::uint64_t, side, side>>(2, 2);
+    acc->shard(0)(0, 0) = 1;
+    acc->shard(1)(side-1, side-1) = 2;
+    acc->atomic_add(side-1, side-1, 3);
+
+    auto const sequential = std::make_unique<ysc::matrix<std::uint64_t, side, side>>();
+    auto const parallel = std::make_unique<ysc::matrix<std::uint64_t, side, side>>();
+    acc->reduce(*sequential);
+    acc->reduce(ysc::parallel, *parallel);
+    ASSERT_EQ((*sequential)(0, 0), 1u);
+    ASSERT_EQ((*sequential)(side-1, side-1), 5u);
+    ASSERT_EQ((*sequential)(512, 3), 0u);
+    for (std::size_t i = 0 ; i < side ; ++i) {
+        for (std::size_t j = 0 ; j < side ; ++j) {
+            ASSERT_EQ((*parallel)(i, j), (*sequential)(i, j));
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#include <matrix_contract.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <type_traits>
+
+
+namespace
+{
+
+template<class T, std::size_t... Dimensions>
+void iota(ysc::matrix<T, Dimensions...>& m, T first)
+{
+    constexpr std::size_t size = (Dimensions * ...);
+    for (std::size_t i = 0 ; i < size ; ++i) {
+        m.data()[i] = first + static_cast<T>(i % 17);
+    }
+}
+
+} // anonymous namespace
+
+
+//
+// --- RESULT TYPE ---
+//
+
+// Expect result dimensions to be batch axes, then free axes of each operand
+TEST(contract, result_type)
+{
+    using a_type = ysc::matrix<int, 2, 3, 4, 5>;
+    using b_type = ysc::matrix<int, 5, 2, 6>;
+    using tensordot = decltype(ysc::contract<ysc::axes<3>, ysc::axes<0>>(a_type{}, b_type{}));
+    using batched = decltype(ysc::contract<ysc::axes<3>, ysc::axes<0>, ysc::axes<0>, ysc::axes<1>>(a_type{}, b_type{}));
+    using full = decltype(ysc::contract<ysc::axes<0, 1>, ysc::axes<0, 1>>(ysc::matrix<int, 2, 3>{}, ysc::matrix<int, 2, 3>{}));
+    ASSERT_TRUE((std::is_same_v<tensordot, ysc::matrix<int, 2, 3, 4, 2, 6>>));
+    ASSERT_TRUE((std::is_same_v<batched, ysc::matrix<int, 2, 3, 4, 6>>));
+    ASSERT_TRUE((std::is_same_v<full, int>));
+}
+
+
+//
+// --- VALUES ---
+//
+
+// Expect the product of order-2 matrices (no transpose needed)
+TEST(contract, matrix_product)
+{
+    ysc::matrix<int, 2, 3> const a = { 1, 2, 3, 4, 5, 6 };
+    ysc::matrix<int, 3, 2> const b = { 7, 8, 9, 10, 11, 12 };
+    auto const c = ysc::contract<ysc::axes<1>, ysc::axes<0>>(a, b);
+    ASSERT_EQ(c(0, 0), 58);
+    ASSERT_EQ(c(0, 1), 64);
+    ASSERT_EQ(c(1, 0), 139);
+    ASSERT_EQ(c(1, 1), 154);
+}
+
+// Expect the product of a transposed matrix (small, loop nest)
+TEST(contract, transposed_product)
+{
+    ysc::matrix<int, 3, 2> const a = { 1, 4, 2, 5, 3, 6 };
+    ysc::matrix<int, 3, 2> const b = { 7, 8, 9, 10, 11, 12 };
+    auto const c = ysc::contract<ysc::axes<0>, ysc::axes<0>>(a, b);
+    ASSERT_EQ(c(0, 0), 58);
+    ASSERT_EQ(c(0, 1), 64);
+    ASSERT_EQ(c(1, 0), 139);
+    ASSERT_EQ(c(1, 1), 154);
+}
+
+// Expect a full contraction to be the sum of element-wise products
+TEST(contract, full)
+{
+    ysc::matrix<int, 2, 2> const a = { 1, 2, 3, 4 };
+    ASSERT_EQ((ysc::contract<ysc::axes<0, 1>, ysc::axes<0, 1>>(a, a)), 30);
+    ASSERT_EQ((ysc::contract<ysc::axes<0, 1>, ysc::axes<1, 0>>(a, a)), 29);
+}
+
+// Expect an order-4 tensor contracted over two transposed axes (large, gather then gemm)
+TEST(contract, order_4)
+{
+    auto const a = std::make_unique<ysc::matrix<long, 6, 20, 7, 30>>();
+    auto const b = std::make_unique<ysc::matrix<long, 30, 9, 20>>();
+    iota(*a, 1L);
+    iota(*b, -8L);
+
+    auto const c = ysc::contract<ysc::axes<3, 1>, ysc::axes<0, 2>>(*a, *b);
+    for (std::size_t i = 0 ; i < 6 ; ++i) {
+        for (std::size_t k = 0 ; k < 7 ; ++k) {
+            for (std::size_t l = 0 ; l < 9 ; ++l) {
+                long expected = 0;
+                for (std::size_t j = 0 ; j < 20 ; ++j) {
+                    for (std::size_t m = 0 ; m < 30 ; ++m) {
+                        expected += (*a)(i, j, k, m) * (*b)(m, l, j);
+                    }
+                }
+                ASSERT_EQ(c(i, k, l), expected);
+            }
+        }
+    }
+}
+
+// Expect a batched product along a leading and a trailing batch axis
+TEST(contract, batched)
+{
+    ysc::matrix<int, 4, 3, 5> a;
+    ysc::matrix<int, 5, 2, 4> b;
+    iota(a, 0);
+    iota(b, 3);
+
+    auto const c = ysc::contract<ysc::axes<2>, ysc::axes<0>, ysc::axes<0>, ysc::axes<2>>(a, b);
+    for (std::size_t n = 0 ; n < 4 ; ++n) {
+        for (std::size_t i = 0 ; i < 3 ; ++i) {
+            for (std::size_t j = 0 ; j < 2 ; ++j) {
+                int expected = 0;
+                for (std::size_t k = 0 ; k < 5 ; ++k) {
+                    expected += a(n, i, k) * b(k, j, n);
+                }
+                ASSERT_EQ(c(n, i, j), expected);
+            }
+        }
+    }
+}
+
+// Expect a parallel contraction to compute the same values as a sequential one
+TEST(contract, parallel)
+{
+    auto const a = std::make_unique<ysc::matrix<double, 3, 90, 80>>();
+    auto const b = std::make_unique<ysc::matrix<double, 80, 100>>();
+    iota(*a, 0.5);
+    iota(*b, -2.);
+
+    auto const sequential = std::make_unique<ysc::matrix<double, 3, 90, 100>>(
+        ysc::contract<ysc::axes<2>, ysc::axes<0>>(*a, *b));
+    auto const parallel = std::make_unique<ysc::matrix<double, 3, 90, 100>>(
+        ysc::contract<ysc::axes<2>, ysc::axes<0>>(ysc::parallel, *a, *b));
+    for (std::size_t i = 0 ; i < 3*90*100 ; ++i) {
+        ASSERT_DOUBLE_EQ(parallel->data()[i], sequential->data()[i]);
+    }
+}
+
+// Expect a parallel batched contraction with a single row per batch to compute the same values
+TEST(contract, parallel_batched)
+{
+    auto const a = std::make_unique<ysc::matrix<double, 64, 300>>();
+    auto const b = std::make_unique<ysc::matrix<double, 64, 300, 20>>();
+    iota(*a, 1.);
+    iota(*b, -3.);
+
+    using batch = ysc::axes<0>;
+    auto const sequential = ysc::contract<ysc::axes<1>, ysc::axes<1>, batch, batch>(*a, *b);
+    auto const parallel = ysc::contract<ysc::axes<1>, ysc::axes<1>, batch, batch>(ysc::parallel, *a, *b);
+    for (std::size_t n = 0 ; n < 64 ; ++n) {
+        for (std::size_t j = 0 ; j < 20 ; ++j) {
+            ASSERT_DOUBLE_EQ(parallel(n, j), sequential(n, j));
+        }
+    }
+}
+
+// Expect a contraction into caller-provided storage to support results too large for the stack
+TEST(contract, large_result)
+{
+    auto const a = std::make_unique<ysc::matrix<double, 16, 256, 32>>();
+    auto const b = std::make_unique<ysc::matrix<double, 16, 32, 512>>();
+    iota(*a, 0.5);
+    iota(*b, -2.);
+
+    using batch = ysc::axes<0>;
+    auto const c = std::make_unique<ysc::matrix<double, 16, 256, 512>>();
+    ysc::contract<ysc::axes<2>, ysc::axes<1>, batch, batch>(*a, *b, *c);
+    auto const p = std::make_unique<ysc::matrix<double, 16, 256, 512>>();
+    ysc::contract<ysc::axes<2>, ysc::axes<1>, batch, batch>(ysc::parallel, *a, *b, *p);
+    for (std::size_t n : { 0, 7, 15 }) {
+        for (std::size_t i : { 0, 100, 255 }) {
+            for (std::size_t j : { 0, 311, 511 }) {
+                double expected = 0.;
+                for (std::size_t k = 0 ; k < 32 ; ++k) {
+                    expected += (*a)(n, i, k) * (*b)(n, k, j);
+                }
+                ASSERT_DOUBLE_EQ((*c)(n, i, j), expected);
+                ASSERT_DOUBLE_EQ((*p)(n, i, j), expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,291 @@
+#include <matrix_linalg.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+
+namespace
+{
+
+// Fills a square matrix with a diagonally dominant (hence regular) random matrix
+template<std::size_t N>
+void make_regular(ysc::matrix<double, N, N>& m, unsigned seed)
+{
+    std::mt19937 engine{seed};
+    std::uniform_real_distribution<double> distribution{-1., 1.};
+    for (std::size_t i = 0 ; i < N ; ++i) {
+        for (std::size_t j = 0 ; j < N ; ++j) {
+            m(i, j) = distribution(engine);
+        }
+        m(i, i) += N;
+    }
+}
+
+// Fills a square matrix with a symmetric positive-definite random matrix
+template<std::size_t N>
+void make_spd(ysc::matrix<double, N, N>& m, unsigned seed)
+{
+    make_regular(m, seed);
+    for (std::size_t i = 0 ; i < N ; ++i) {
+        for (std::size_t j = 0 ; j < i ; ++j) {
+            m(j, i) = m(i, j);
+        }
+    }
+}
+
+// Returns max |A x - b|
+template<std::size_t N>
+double residual(ysc::matrix<double, N, N> const& a, ysc::matrix<double, N> const& x, ysc::matrix<double, N> const& b)
+{
+    double result = 0.;
+    for (std::size_t i = 0 ; i < N ; ++i) {
+        double sum = -b(i);
+        for (std::size_t j = 0 ; j < N ; ++j) {
+            sum += a(i, j) * x(j);
+        }
+        result = std::max(result, std::abs(sum));
+    }
+    return result;
+}
+
+template<std::size_t N>
+ysc::matrix<double, N> make_rhs()
+{
+    ysc::matrix<double, N> b;
+    for (std::size_t i = 0 ; i < N ; ++i) {
+        b(i) = static_cast<double>(i) - N/2.;
+    }
+    return b;
+}
+
+template<std::size_t N>
+void check_lu_solve()
+{
+    auto const a = std::make_unique<ysc::matrix<double, N, N>>();
+    make_regular(*a, N);
+    auto const b = make_rhs<N>();
+    auto const x = ysc::solve(*a, b);
+    ASSERT_LT(residual(*a, x, b), 1e-9);
+}
+
+template<std::size_t N>
+void check_cholesky_solve()
+{
+    auto const a = std::make_unique<ysc::matrix<double, N, N>>();
+    make_spd(*a, N);
+    auto const b = make_rhs<N>();
+    auto const x = ysc::cholesky(*a).solve(b);
+    ASSERT_LT(residual(*a, x, b), 1e-9);
+}
+
+} // anonymous namespace
+
+
+//
+// --- LU ---
+//
+
+// Expect LU factors to be packed and pivoted
+TEST(linalg_lu, factors)
+{
+    ysc::matrix<double, 2, 2> const m = { 1., 2., 4., 2. };
+    auto const f = ysc::lu(m);
+    ASSERT_FALSE(f.singular());
+    ASSERT_EQ(f.pivots()[0], 1u);
+    ASSERT_DOUBLE_EQ(f.packed()(0, 0), 4.);
+    ASSERT_DOUBLE_EQ(f.packed()(0, 1), 2.);
+    ASSERT_DOUBLE_EQ(f.packed()(1, 0), .25);
+    ASSERT_DOUBLE_EQ(f.packed()(1, 1), 1.5);
+}
+
+// Expect systems to be solved with fully unrolled, unblocked and blocked factorizations
+TEST(linalg_lu, solve)
+{
+    check_lu_solve<3>();
+    check_lu_solve<8>();
+    check_lu_solve<40>();
+    check_lu_solve<150>();
+}
+
+// Expect a batch of right-hand sides to be solved from a single factorization
+TEST(linalg_lu, solve_batch)
+{
+    ysc::matrix<double, 70, 70> a;
+    make_regular(a, 70);
+    ysc::matrix<double, 70, 3> b;
+    for (std::size_t i = 0 ; i < 70 ; ++i) {
+        for (std::size_t k = 0 ; k < 3 ; ++k) {
+            b(i, k) = static_cast<double>(i * (k+1));
+        }
+    }
+
+    auto const f = ysc::lu(a);
+    auto const x = f.solve(b);
+    for (std::size_t k = 0 ; k < 3 ; ++k) {
+        ysc::matrix<double, 70> b_k, x_k;
+        for (std::size_t i = 0 ; i < 70 ; ++i) {
+            b_k(i) = b(i, k);
+            x_k(i) = x(i, k);
+        }
+        ASSERT_LT(residual(a, x_k, b_k), 1e-9);
+    }
+}
+
+// Expect determinants to account for row interchanges
+TEST(linalg_lu, determinant)
+{
+    ysc::matrix<double, 3, 3> const m = { 0., 2., 1., 1., 0., 0., 0., 0., 3. };
+    ASSERT_DOUBLE_EQ(ysc::determinant(m), -6.);
+
+    ysc::matrix<double, 2, 2> const singular = { 1., 2., 2., 4. };
+    ASSERT_DOUBLE_EQ(ysc::determinant(singular), 0.);
+}
+
+// Expect logarithmic determinants to carry the sign of the determinant
+TEST(linalg_lu, log_determinant)
+{
+    ysc::matrix<double, 3, 3> const m = { 0., 2., 1., 1., 0., 0., 0., 0., 3. };
+    auto const [sign, log_abs] = ysc::log_determinant(m);
+    ASSERT_DOUBLE_EQ(sign, -1.);
+    ASSERT_DOUBLE_EQ(log_abs, std::log(6.));
+
+    ysc::matrix<double, 2, 2> const singular = { 1., 2., 2., 4. };
+    auto const null = ysc::log_determinant(singular);
+    ASSERT_EQ(null.sign, 0.);
+    ASSERT_TRUE(std::isinf(null.log_abs) && null.log_abs < 0.);
+}
+
+// Expect logarithmic determinants of large matrices not to overflow, unlike determinants
+TEST(linalg_lu, log_determinant_large)
+{
+    constexpr std::size_t N = 257;
+    auto const a = std::make_unique<ysc::matrix<double, N, N>>();
+    make_spd(*a, N);
+    auto const lu = ysc::lu(*a).log_determinant();
+    auto const cholesky = ysc::cholesky(*a).log_determinant();
+    ASSERT_TRUE(std::isinf(ysc::determinant(*a)));
+    ASSERT_DOUBLE_EQ(lu.sign, 1.);
+    ASSERT_DOUBLE_EQ(cholesky.sign, 1.);
+    ASSERT_TRUE(std::isfinite(lu.log_abs));
+    ASSERT_NEAR(lu.log_abs, cholesky.log_abs, 1e-9 * lu.log_abs);
+}
+
+// Expect a matrix times its inverse to be the identity
+TEST(linalg_lu, inverse)
+{
+    ysc::matrix<double, 100, 100> a;
+    make_regular(a, 100);
+    auto const inv = ysc::inverse(a);
+    for (std::size_t i = 0 ; i < 100 ; ++i) {
+        for (std::size_t j = 0 ; j < 100 ; ++j) {
+            double sum = 0.;
+            for (std::size_t k = 0 ; k < 100 ; ++k) {
+                sum += a(i, k) * inv(k, j);
+            }
+            ASSERT_NEAR(sum, i == j ? 1. : 0., 1e-12);
+        }
+    }
+}
+
+// Expect large systems to be solved without overflowing the stack (blocked path)
+TEST(linalg_lu, solve_large)
+{
+    constexpr std::size_t n = 1024;
+    auto const a = std::make_unique<ysc::matrix<double, n, n>>();
+    make_regular(*a, n);
+    auto const b = std::make_unique<ysc::matrix<double, n>>(make_rhs<n>());
+
+    auto const x = std::make_unique<ysc::matrix<double, n>>(ysc::solve(*a, *b));
+    ASSERT_LT(residual(*a, *x, *b), 1e-9);
+
+    auto const x_out = std::make_unique<ysc::matrix<double, n>>();
+    ysc::lu(*a).solve(*b, *x_out);
+    ASSERT_LT(residual(*a, *x_out, *b), 1e-9);
+}
+
+// Expect inverses to be computed into caller-provided storage
+TEST(linalg_lu, inverse_out)
+{
+    constexpr std::size_t n = 100;
+    auto const a = std::make_unique<ysc::matrix<double, n, n>>();
+    make_regular(*a, n);
+    auto const inv = std::make_unique<ysc::matrix<double, n, n>>();
+    ysc::inverse(*a, *inv);
+    auto const expected = ysc::inverse(*a);
+    for (std::size_t i = 0 ; i < n ; ++i) {
+        for (std::size_t j = 0 ; j < n ; ++j) {
+            ASSERT_DOUBLE_EQ((*inv)(i, j), expected(i, j));
+        }
+    }
+}
+
+// Expect solving a singular system to throw
+TEST(linalg_lu, singular)
+{
+    ysc::matrix<double, 2, 2> const m = { 1., 2., 2., 4. };
+    auto const f = ysc::lu(m);
+    ASSERT_TRUE(f.singular());
+
+    bool domain_error_catch = false;
+    try {
+        (void) f.solve(ysc::matrix<double, 2>{1., 1.});
+    } catch (std::domain_error&) {
+        domain_error_catch = true;
+    }
+    ASSERT_TRUE(domain_error_catch);
+}
+
+
+//
+// --- CHOLESKY ---
+//
+
+// Expect the lower factor to be lower triangular
+TEST(linalg_cholesky, factors)
+{
+    ysc::matrix<double, 2, 2> const m = { 4., 2., 2., 5. };
+    auto const f = ysc::cholesky(m);
+    ASSERT_DOUBLE_EQ(f.lower()(0, 0), 2.);
+    ASSERT_DOUBLE_EQ(f.lower()(0, 1), 0.);
+    ASSERT_DOUBLE_EQ(f.lower()(1, 0), 1.);
+    ASSERT_DOUBLE_EQ(f.lower()(1, 1), 2.);
+    ASSERT_DOUBLE_EQ(f.determinant(), 16.);
+}
+
+// Expect systems to be solved with fully unrolled and blocked factorizations
+TEST(linalg_cholesky, solve)
+{
+    check_cholesky_solve<3>();
+    check_cholesky_solve<8>();
+    check_cholesky_solve<40>();
+    check_cholesky_solve<150>();
+}
+
+// Expect large systems to be solved without overflowing the stack (blocked path)
+TEST(linalg_cholesky, solve_large)
+{
+    constexpr std::size_t n = 1024;
+    auto const a = std::make_unique<ysc::matrix<double, n, n>>();
+    make_spd(*a, n);
+    auto const b = std::make_unique<ysc::matrix<double, n>>(make_rhs<n>());
+    auto const x = std::make_unique<ysc::matrix<double, n>>();
+    ysc::cholesky(*a).solve(*b, *x);
+    ASSERT_LT(residual(*a, *x, *b), 1e-9);
+}
+
+// Expect factoring a matrix which is not positive definite to throw
+TEST(linalg_cholesky, not_positive_definite)
+{
+    ysc::matrix<double, 2, 2> const m = { 1., 2., 2., 1. };
+
+    bool domain_error_catch = false;
+    try {
+        (void) ysc::cholesky(m);
+    } catch (std::domain_error&) {
+        domain_error_catch = true;
+    }
+    ASSERT_TRUE(domain_error_catch);
+}
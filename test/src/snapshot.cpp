@@ -0,0 +1,266 @@
+#include <matrix_snapshot.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <new>
+#include <optional>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+// Element type whose copy throws on demand
+struct throwing_copy
+{
+    static inline bool armed = false;
+    int value = 0;
+
+    throwing_copy() = default;
+    throwing_copy(throwing_copy const& other)
+        : value(other.value)
+    {
+        if (armed) {
+            throw std::bad_alloc{};
+        }
+    }
+    throwing_copy& operator=(throwing_copy const&) = default;
+};
+
+// Element type whose default construction throws on demand, counting live instances
+struct throwing_default
+{
+    static inline int countdown = -1;
+    static inline int live = 0;
+    int value = 0;
+
+    throwing_default()
+    {
+        if (countdown >= 0 && countdown-- == 0) {
+            throw std::bad_alloc{};
+        }
+        ++live;
+    }
+    throwing_default(throwing_default const& other)
+        : value(other.value)
+    { ++live; }
+    throwing_default& operator=(throwing_default const&) = default;
+    ~throwing_default()
+    { --live; }
+};
+
+} // anonymous namespace
+
+
+//
+// --- VERSIONS ---
+//
+
+// Expect an initial value not to be mistaken for a reader limit
+TEST(snapshot, initial_value)
+{
+    ysc::versioned_matrix<int, 1> v{7};
+    ASSERT_EQ(v(0), 7);
+    auto r1 = v.register_reader();
+    auto r2 = v.register_reader();
+    ASSERT_EQ(r2.acquire()(0), 7);
+}
+
+// Expect version 0 to be a copy of the initial matrix
+TEST(snapshot, initial)
+{
+    ysc::matrix<int, 2, 3> const m = { 1, 2, 3, 4, 5, 6 };
+    ysc::versioned_matrix<int, 2, 3> v{m};
+    auto r = v.register_reader();
+    auto const s = r.acquire();
+    ASSERT_EQ(s.number(), 0u);
+    ASSERT_EQ(s(0, 0), 1);
+    ASSERT_EQ(s(1, 2), 6);
+    ASSERT_EQ(v(1, 1), 5);
+}
+
+// Expect snapshots to keep reading their own version
+TEST(snapshot, isolation)
+{
+    ysc::versioned_matrix<int, 4, 4> v;
+    auto r = v.register_reader();
+    auto const before = r.acquire();
+
+    v.modify(2, 3) = 7;
+    ASSERT_EQ(v(2, 3), 7);
+    ASSERT_EQ(before(2, 3), 0);
+
+    v.publish();
+    auto const after = r.acquire();
+    ASSERT_EQ(v.published(), 1u);
+    ASSERT_EQ(after.number(), 1u);
+    ASSERT_EQ(after(2, 3), 7);
+    ASSERT_EQ(before(2, 3), 0);
+}
+
+// Expect unmodified tiles to be shared between versions, modified ones copied
+TEST(snapshot, copy_on_write)
+{
+    using versioned = ysc::versioned_matrix<double, 2, 1024>;
+    ASSERT_EQ(versioned::tile_size, 512u);
+
+    versioned v;
+    auto r = v.register_reader();
+    auto const before = r.acquire();
+    v.modify(0, 0) = 1.;
+    v.publish();
+    auto const after = r.acquire();
+
+    ASSERT_NE(&before(0, 0), &after(0, 0));
+    ASSERT_EQ(&before(0, 600), &after(0, 600));
+    ASSERT_EQ(&before(1, 0), &after(1, 0));
+}
+
+// Expect a snapshot to be copyable into a matrix
+TEST(snapshot, copy)
+{
+    ysc::versioned_matrix<char, 3, 2000> v;
+    v.modify(2, 1999) = 'z';
+    v.publish();
+
+    auto r = v.register_reader();
+    auto const m = std::make_unique<ysc::matrix<char, 3, 2000>>(r.acquire().copy());
+    ASSERT_EQ((*m)(2, 1999), 'z');
+    ASSERT_EQ((*m)(0, 0), '\0');
+}
+
+// Expect a failed tile copy to leave the pending version untouched
+TEST(snapshot, modify_exception_safety)
+{
+    ysc::versioned_matrix<throwing_copy, 4> v;
+    throwing_copy::armed = true;
+    bool bad_alloc_catch = false;
+    try {
+        v.modify(1).value = 1;
+    } catch (std::bad_alloc&) {
+        bad_alloc_catch = true;
+    }
+    throwing_copy::armed = false;
+    ASSERT_TRUE(bad_alloc_catch);
+    ASSERT_EQ(v(1).value, 0);
+
+    v.modify(1).value = 2;
+    v.publish();
+    ASSERT_EQ(v(1).value, 2);
+}
+
+// Expect construction to free the tiles already allocated when a later one throws
+TEST(snapshot, construction_exception_safety)
+{
+    using matrix_type = ysc::versioned_matrix<throwing_default, 3, 1024>;
+    ASSERT_GT(matrix_type::tile_size, 1u);
+    ASSERT_LT(matrix_type::tile_size, 2048u);
+    throwing_default::countdown = static_cast<int>(matrix_type::tile_size) + 1;
+    bool bad_alloc_catch = false;
+    try {
+        matrix_type v;
+    } catch (std::bad_alloc&) {
+        bad_alloc_catch = true;
+    }
+    throwing_default::countdown = -1;
+    ASSERT_TRUE(bad_alloc_catch);
+    ASSERT_EQ(throwing_default::live, 0);
+}
+
+//
+// --- READERS ---
+//
+
+// Expect registering too many readers to throw
+TEST(snapshot, too_many_readers)
+{
+    ysc::versioned_matrix<int, 1> v{ysc::max_readers{1}};
+    auto r = v.register_reader();
+
+    bool length_error_catch = false;
+    try {
+        (void) v.register_reader();
+    } catch (std::length_error&) {
+        length_error_catch = true;
+    }
+    ASSERT_TRUE(length_error_catch);
+}
+
+// Expect retired versions to be freed only once no snapshot can reach them
+TEST(snapshot, reclamation)
+{
+    ysc::versioned_matrix<int, 8> v;
+    auto r = v.register_reader();
+    {
+        auto const pinned = r.acquire();
+        v.modify(0) = 1;
+        v.publish();
+        v.modify(0) = 2;
+        v.publish();
+        ASSERT_EQ(v.retired_versions(), 2u);
+        ASSERT_EQ(pinned(0), 0);
+    }
+    v.reclaim();
+    ASSERT_EQ(v.retired_versions(), 0u);
+
+    v.modify(0) = 3;
+    v.publish();
+    ASSERT_EQ(v.retired_versions(), 0u);
+}
+
+// Expect a snapshot taken before its reader is moved to unpin the reader once destroyed
+TEST(snapshot, reclamation_moved_reader)
+{
+    ysc::versioned_matrix<int, 8> v;
+    auto r = v.register_reader();
+    auto pinned = std::make_optional(r.acquire());
+    auto moved = std::move(r);
+    v.modify(0) = 1;
+    v.publish();
+    ASSERT_EQ(v.retired_versions(), 1u);
+    pinned.reset();
+
+    v.modify(0) = 2;
+    v.publish();
+    ASSERT_EQ(v.retired_versions(), 0u);
+    ASSERT_EQ(moved.acquire()(0), 2);
+}
+
+// Expect concurrent readers to only ever observe consistent, published versions
+TEST(snapshot, concurrent)
+{
+    constexpr std::size_t readers = 3;
+    constexpr int versions = 2000;
+    ysc::versioned_matrix<int, 4, 512> v;
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0 ; t < readers ; ++t) {
+        threads.emplace_back([&] {
+            auto r = v.register_reader();
+            while (!done.load()) {
+                auto const s = r.acquire();
+                int const expected = static_cast<int>(s.number());
+                if (s(0, 0) != expected || s(3, 511) != expected) {
+                    consistent.store(false);
+                }
+            }
+        });
+    }
+    for (int n = 1 ; n <= versions ; ++n) {
+        v.modify(0, 0) = n;
+        v.modify(3, 511) = n;
+        v.publish();
+    }
+    done.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_TRUE(consistent.load());
+    v.reclaim();
+    ASSERT_EQ(v.retired_versions(), 0u);
+}